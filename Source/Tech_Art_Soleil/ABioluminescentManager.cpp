@@ -3,32 +3,60 @@
 
 #include "ABioluminescentManager.h"
 
+#include "GlowCurveSubsystem.h"
+#include "GlowMushroomField.h"
+#include "GlowMushroomFieldComponent.h"
+#include "GlowOcclusionSubsystem.h"
+#include "GlowScalability.h"
+#include "GlowTrace.h"
 #include "Landscape.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+#include "LuminescentObject.h"
+#include "LuminescentSignificanceSubsystem.h"
+#include "Tech_Art_Soleil.h"
+#include "WaterBodyActor.h"
+#include "WaterBodyComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "Engine/Canvas.h"
+#include "Components/RuntimeVirtualTextureComponent.h"
 #include "Engine/StaticMeshActor.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "Kismet/KismetRenderingLibrary.h"
 #include "Runtime/Foliage/Public/InstancedFoliageActor.h"
+#include "VT/RuntimeVirtualTexture.h"
+#include "VT/RuntimeVirtualTextureVolume.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred manager points"), STAT_DeferredManagerPoints, STATGROUP_Bioluminescence);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Merged manager points"), STAT_MergedManagerPoints, STATGROUP_Bioluminescence);
+DECLARE_CYCLE_STAT(TEXT("Manager simulation"), STAT_ManagerSimulation, STATGROUP_Bioluminescence);
 
 #pragma region Loading
 ABioluminescentManager::ABioluminescentManager()
 {
 	PrimaryActorTick.bCanEverTick = true;
+
+	// Only the propagation starts are replicated, every client has to receive them wherever it is
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	LightPool = CreateDefaultSubobject<UGlowLightPoolComponent>(TEXT("LightPool"));
 }
 
 void ABioluminescentManager::BeginPlay()
 {
 	Super::BeginPlay();
 
+	TRACE_GLOW_OWNER(*this);
+
+	Occlusion = GetWorld()->GetSubsystem<UGlowOcclusionSubsystem>();
+	bRendered = GlowScalability::IsRendered(*GetWorld());
+
 	// Find all the materials in the scene and create a dynamic instance of them
-	LoadMushrooms();
-	LoadRocks();
-	LoadLandscape();
-	LoadFoliage();
+	LoadParticipants();
 	LoadPlayer();
+	LoadHands();
+	LoadCollisions();
+	LoadGlowMask();
 
 	for (UMaterialInstanceDynamic* const Material : Materials)
 	{
@@ -42,145 +70,630 @@ void ABioluminescentManager::BeginPlay()
 	// Ratio between the total propagation time, and the fade out duration
 	FadeOutTimeRatio = TotalPropagationTime / FadeOutDuration;
 
-	SetupRenderTarget();
+	// The own values are profile 0, a profile set only adds the surfaces that differ from them
+	OwnProfile = FGlowPropagationProfile(PropagationDistance, PropagationSpeed, IntensityRatio, FadeOutDelay, FadeOutDuration);
+
+	// Bake the curves once, so neither the CPU nor the shader evaluates them afterwards
+	PropagationTable.Bake(PropagationCurve, [](const float Time) -> float { return FMath::InterpEaseOut(0.f, 1.f, Time, 3.f); });
+	FadeOutTable.Bake(FadeOutCurve, [](const float Time) -> float { return Time; });
+
+	// Nothing to upload to when nothing is drawn
+	if (bRendered)
+		SetupRenderTarget();
+
+	// The simulation launched by Tick completes late in the frame, whatever ticks in between runs alongside it
+	SimulationTickFunction.Manager = this;
+	SimulationTickFunction.TickGroup = TG_PostUpdateWork;
+	SimulationTickFunction.bCanEverTick = true;
+	SimulationTickFunction.AddPrerequisite(this, PrimaryActorTick);
+	SimulationTickFunction.RegisterTickFunction(GetLevel());
+
+	UE_LOG(LogBioluminescence, Display, TEXT("Propagation events replicate in about %lld bits each"),
+		FPropagationEvent(GetActorLocation(), PropagationDistance).GetSerializedBits());
+
+	// The textures never change, only their content does, so bind them once
+	for (UMaterialInstanceDynamic* const Material : Materials)
+	{
+		Material->SetTextureParameterValue("PointsArray", PointsTexture);
+		Material->SetTextureParameterValue("TimesArray", TimesTexture);
+		Material->SetTextureParameterValue("PropagationCurves", CurvesTexture);
+
+		// Shared by every glow using the same set
+		if (ProfileSet)
+			Material->SetTextureParameterValue("PropagationProfiles", ProfileSet->GetTexture());
+	}
+
+	for (UMaterialInstanceDynamic* const Material : WaterMaterials)
+	{
+		Material->SetTextureParameterValue("RippleHeights", RippleTexture);
+		Material->SetVectorParameterValue("RippleWindow", Ripples->GetWindow());
+	}
 }
 
-void ABioluminescentManager::LoadMushrooms()
+void ABioluminescentManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	LoadActorType(MushroomClass);
+	// The task writes into the point buffer
+	CompleteSimulation();
+	SimulationTickFunction.UnRegisterTickFunction();
+
+	if (PointBuffer)
+		PointBuffer->Release();
+
+	CollisionStream.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
-void ABioluminescentManager::LoadRocks()
+void ABioluminescentManager::LoadParticipants()
 {
-	LoadActorType(AStaticMeshActor::StaticClass());
+	// The editor plays levels with unsaved changes, which the manifest can't know about
+	bool bUseManifest = bHasManifest && !GetWorld()->IsPlayInEditor();
+
+	// A level saved without running the commandlet again would otherwise lose or keep participants silently
+	if (bUseManifest && ManifestSignature != ComputeLevelSignature())
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("%s: the level changed since its participant manifest was built, scanning the world instead, run the GlowManifest commandlet"), *GetName());
+		bUseManifest = false;
+	}
+
+	FParticipantList List;
+	if (bUseManifest)
+	{
+		ResolveManifest(List);
+	}
+	else
+	{
+		if (!bHasManifest)
+			UE_LOG(LogBioluminescence, Warning, TEXT("%s has no participant manifest, scanning the world instead, run the GlowManifest commandlet"), *GetName());
+
+		GatherParticipants(*GetWorld(), List);
+	}
+
+	for (UPrimitiveComponent* const Component : List.Surfaces)
+		RegisterParticipant(Component);
+
+	for (UPrimitiveComponent* const Component : List.QueryOnly)
+		Participants.Add(Component);
+
+	for (AWaterBody* const WaterBody : List.WaterBodies)
+		RegisterWaterBody(*WaterBody);
+
+	// Nothing draws the mask on a dedicated server or a null RHI run, see LoadGlowMask
+	if (bRendered)
+		GlowMaskVolumes = TArray<TObjectPtr<URuntimeVirtualTextureComponent>>(List.GlowMaskVolumes);
+
+	if (WaterMaterials.IsEmpty())
+		return;
+
+	Ripples = MakeUnique<FRippleHeightfield>(RippleCellSize);
+	RippleTexture = FRippleHeightfield::CreateTexture();
 }
 
-void ABioluminescentManager::LoadLandscape()
+void ABioluminescentManager::ResolveManifest(FParticipantList& List) const
 {
+	// Everything referenced lives in the level, so it is already loaded
+	for (const TSoftObjectPtr<UPrimitiveComponent>& Surface : ManifestSurfaces)
+	{
+		if (UPrimitiveComponent* const Component = Surface.Get())
+			List.Surfaces.Add(Component);
+	}
+
+	for (const TSoftObjectPtr<UPrimitiveComponent>& QueryOnly : ManifestQueryOnly)
+	{
+		if (UPrimitiveComponent* const Component = QueryOnly.Get())
+			List.QueryOnly.Add(Component);
+	}
+
+	for (const TSoftObjectPtr<AWaterBody>& WaterBody : ManifestWaterBodies)
+	{
+		if (AWaterBody* const Actor = WaterBody.Get())
+			List.WaterBodies.Add(Actor);
+	}
+
+	// The mask can be changed without rebuilding the manifest, only the volumes still drawing it count
+	for (const TSoftObjectPtr<URuntimeVirtualTextureComponent>& GlowMaskVolume : ManifestGlowMaskVolumes)
+	{
+		URuntimeVirtualTextureComponent* const Volume = GlowMaskVolume.Get();
+		if (Volume && GlowMask && Volume->GetVirtualTexture() == GlowMask)
+			List.GlowMaskVolumes.Add(Volume);
+	}
+}
+
+uint32 ABioluminescentManager::ComputeLevelSignature() const
+{
+	const ULevel* const Level = GetLevel();
+	if (!Level)
+		return 0;
+
+	// Same classes as GatherParticipants looks for, editor only actors never match them so cooking doesn't change the set
+	const auto IsGathered = [this](const AActor& Actor) -> bool
+	{
+		return (MushroomClass && Actor.IsA(MushroomClass))
+			|| Actor.IsA<AStaticMeshActor>()
+			|| Actor.IsA<AGlowMushroomField>()
+			|| Actor.IsA<ALandscape>()
+			|| Actor.IsA<AInstancedFoliageActor>()
+			|| Actor.IsA<AWaterBody>()
+			|| Actor.IsA<ARuntimeVirtualTextureVolume>();
+	};
+
+	// Only the actors saved with the level, those spawned at runtime aren't in the manifest either
+	TArray<FString> Names;
+	for (const AActor* const Actor : Level->Actors)
+	{
+		if (Actor && Actor->HasAnyFlags(RF_WasLoaded) && IsGathered(*Actor))
+			Names.Add(Actor->GetName());
+	}
+
+	// The order of the actors isn't kept by a save
+	Names.Sort();
+
+	uint32 Signature = 0;
+	for (const FString& Name : Names)
+		Signature = FCrc::StrCrc32(*Name, Signature);
+
+	return Signature;
+}
+
+void ABioluminescentManager::GatherParticipants(UWorld& World, FParticipantList& List) const
+{
+	// Mushrooms and rocks
+	GatherActorType(World, MushroomClass, List);
+	GatherActorType(World, AStaticMeshActor::StaticClass(), List);
+
+	// Mushroom fields, each variant is a single component
+	TArray<AActor*> MushroomFields;
+	UGameplayStatics::GetAllActorsOfClass(&World, AGlowMushroomField::StaticClass(), MushroomFields);
+	for (const AActor* const Field : MushroomFields)
+	{
+		TArray<UGlowMushroomFieldComponent*> Variants;
+		Field->GetComponents<UGlowMushroomFieldComponent>(Variants);
+
+		for (UGlowMushroomFieldComponent* const Variant : Variants)
+		{
+			if (UsesGlowParameters(*Variant))
+				List.Surfaces.Add(Variant);
+		}
+	}
+
 	// The Landscape
-	AActor* const Landscape = UGameplayStatics::GetActorOfClass(GetWorld(), ALandscape::StaticClass());
-	const TArray<TObjectPtr<ULandscapeComponent>> Components = Cast<ALandscape>(Landscape)->LandscapeComponents;
-	for (const TObjectPtr<ULandscapeComponent> LandscapeComponent : Components)
+	if (const ALandscape* const Landscape = Cast<ALandscape>(UGameplayStatics::GetActorOfClass(&World, ALandscape::StaticClass())))
 	{
-		LandscapeComponent->OnComponentHit.AddDynamic(this, &ABioluminescentManager::OnHit);
-		for (int32 i = 0; i < LandscapeComponent->GetNumMaterials(); i++)
-			Materials.Add(LandscapeComponent->CreateDynamicMaterialInstance(i, LandscapeComponent->GetMaterial(i)));
+		const int32 NumSurfaces = List.Surfaces.Num();
+		for (const TObjectPtr<ULandscapeComponent> LandscapeComponent : Landscape->LandscapeComponents)
+		{
+			if (UsesGlowParameters(*LandscapeComponent))
+				List.Surfaces.Add(LandscapeComponent);
+		}
+
+		// Queries find the collision components rather than the rendered ones
+		if (List.Surfaces.Num() > NumSurfaces)
+			List.QueryOnly.Append(Landscape->CollisionComponents);
+	}
+
+	// The Foliage
+	if (const AActor* const FoliageActor = UGameplayStatics::GetActorOfClass(&World, AInstancedFoliageActor::StaticClass()))
+	{
+		TArray<UFoliageInstancedStaticMeshComponent*> FoliageComponents;
+		FoliageActor->GetComponents<UFoliageInstancedStaticMeshComponent>(FoliageComponents);
+
+		for (UFoliageInstancedStaticMeshComponent* const FoliageComponent : FoliageComponents)
+		{
+			if (UsesGlowParameters(*FoliageComponent))
+				List.Surfaces.Add(FoliageComponent);
+		}
+	}
+
+	// The Water
+	TArray<AActor*> WaterBodies;
+	UGameplayStatics::GetAllActorsOfClass(&World, AWaterBody::StaticClass(), WaterBodies);
+	for (AActor* const Actor : WaterBodies)
+	{
+		AWaterBody* const WaterBody = Cast<AWaterBody>(Actor);
+		const UWaterBodyComponent* const WaterBodyComponent = WaterBody->GetWaterBodyComponent();
+		if (WaterBodyComponent && UsesGlowParameters(WaterBodyComponent->GetWaterMaterial()))
+			List.WaterBodies.Add(WaterBody);
+	}
+
+	// The volumes drawing the glow mask
+	if (!GlowMask)
+		return;
+
+	TArray<AActor*> Volumes;
+	UGameplayStatics::GetAllActorsOfClass(&World, ARuntimeVirtualTextureVolume::StaticClass(), Volumes);
+	for (const AActor* const Actor : Volumes)
+	{
+		URuntimeVirtualTextureComponent* const Volume = Cast<ARuntimeVirtualTextureVolume>(Actor)->GetVirtualTextureComponent();
+		if (Volume && Volume->GetVirtualTexture() == GlowMask)
+			List.GlowMaskVolumes.Add(Volume);
 	}
 }
 
-void ABioluminescentManager::LoadFoliage()
+void ABioluminescentManager::GatherActorType(UWorld& World, const TSubclassOf<AActor>& Class, FParticipantList& List)
 {
-	const AActor* const FoliageActor = UGameplayStatics::GetActorOfClass(GetWorld(), AInstancedFoliageActor::StaticClass());
-	
-	TArray<UFoliageInstancedStaticMeshComponent*> FoliageComponents;
-	FoliageActor->GetComponents<UFoliageInstancedStaticMeshComponent>(FoliageComponents);
+	if (!Class)
+		return;
 
-	for (UFoliageInstancedStaticMeshComponent* const FoliageComponent : FoliageComponents)
+	TArray<AActor*> Actors;
+	// Get all actors of specified type
+	UGameplayStatics::GetAllActorsOfClass(&World, Class, Actors);
+	for (const AActor* const Actor : Actors)
 	{
-		FoliageComponent->OnComponentHit.AddDynamic(this, &ABioluminescentManager::OnHit);
+		UStaticMeshComponent* const StaticMesh = Actor->GetComponentByClass<UStaticMeshComponent>();
+		if (StaticMesh && UsesGlowParameters(*StaticMesh))
+			List.Surfaces.AddUnique(StaticMesh);
+	}
+}
 
-		for (int32 i = 0; i < FoliageComponent->GetNumMaterials(); i++)
-			Materials.Add(FoliageComponent->CreateDynamicMaterialInstance(i, FoliageComponent->GetMaterial(i)));
+bool ABioluminescentManager::UsesGlowParameters(const UPrimitiveComponent& Component)
+{
+	for (int32 i = 0; i < Component.GetNumMaterials(); i++)
+	{
+		if (UsesGlowParameters(Component.GetMaterial(i)))
+			return true;
 	}
+
+	return false;
+}
+
+bool ABioluminescentManager::UsesGlowParameters(const UMaterialInterface* const Material)
+{
+	if (!Material)
+		return false;
+
+	// Every glow material reads the points, the other parameters are optional
+	TArray<FMaterialParameterInfo> ParameterInfos;
+	TArray<FGuid> ParameterIds;
+	Material->GetAllTextureParameterInfo(ParameterInfos, ParameterIds);
+
+	return ParameterInfos.ContainsByPredicate([](const FMaterialParameterInfo& Info) -> bool
+	{
+		return Info.Name == TEXT("PointsArray");
+	});
 }
 
+#if WITH_EDITOR
+void ABioluminescentManager::BuildManifest()
+{
+	FParticipantList List;
+	GatherParticipants(*GetWorld(), List);
+
+	// Before the change, so the transaction records the previous manifest
+	Modify();
+
+	ManifestSurfaces = TArray<TSoftObjectPtr<UPrimitiveComponent>>(List.Surfaces);
+	ManifestQueryOnly = TArray<TSoftObjectPtr<UPrimitiveComponent>>(List.QueryOnly);
+	ManifestWaterBodies = TArray<TSoftObjectPtr<AWaterBody>>(List.WaterBodies);
+	ManifestGlowMaskVolumes = TArray<TSoftObjectPtr<URuntimeVirtualTextureComponent>>(List.GlowMaskVolumes);
+	ManifestSignature = ComputeLevelSignature();
+	bHasManifest = true;
+}
+#endif
+
 void ABioluminescentManager::LoadPlayer()
 {
 	// The Player
 	const APawn* const Player = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+
+	// A dedicated server has no local player, only the collisions start propagations there
+	if (!Player)
+		return;
+
     UCapsuleComponent* const Collider = Player->GetComponentByClass<UCapsuleComponent>();
 	Collider->OnComponentHit.AddDynamic(this, &ABioluminescentManager::OnHit);
 
 	PlayerMovement = Cast<ATech_Art_SoleilCharacter>(Player)->GetCharacterMovement();
 }
 
-void ABioluminescentManager::LoadActorType(const TSubclassOf<AActor>& Class)
+void ABioluminescentManager::LoadHands()
 {
-	TArray<AActor*> Actors;
-	// Get all actors of specified type
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), Class, Actors);
-	for (const AActor* const Actor : Actors)
+	if (!bUseHandContacts)
+		return;
+
+	// Recorded and synthetic streams stand in for the headset when testing
+	TUniquePtr<IHandJointSource> Source;
+	if (!RecordedHandJoints.FilePath.IsEmpty())
+		Source = FRecordedHandJointSource::LoadFromFile(RecordedHandJoints.FilePath);
+	else if (bUseSyntheticHands)
+		Source = FRecordedHandJointSource::MakeTapping(GetActorLocation(), 1.f);
+
+	if (!Source)
+		Source = MakeUnique<FOpenXRHandJointSource>();
+
+	HandContacts = MakeUnique<FHandContactDetector>(MoveTemp(Source));
+}
+
+void ABioluminescentManager::RegisterWaterBody(AWaterBody& WaterBody)
+{
+	UWaterBodyComponent* const WaterBodyComponent = WaterBody.GetWaterBodyComponent();
+	if (!WaterBodyComponent)
+		return;
+
+	for (UPrimitiveComponent* const Collision : WaterBodyComponent->GetCollisionComponents())
 	{
-		UStaticMeshComponent* const StaticMesh = Actor->GetComponentByClass<UStaticMeshComponent>();
-		StaticMesh->OnComponentHit.AddDynamic(this, &ABioluminescentManager::OnHit);
+		Collision->OnComponentBeginOverlap.AddDynamic(this, &ABioluminescentManager::OnWaterOverlap);
+		Participants.Add(Collision);
+		WaterParticipants.Add(Collision);
+	}
 
-		// Instantiate each material of the mesh
-		for (int i = 0; i < StaticMesh->GetNumMaterials(); i++)
-			Materials.Add(StaticMesh->CreateDynamicMaterialInstance(i, StaticMesh->GetMaterial(i)));
+	// Only the collisions matter when nothing is drawn
+	if (!bRendered)
+		return;
+
+	// The water body already owns a dynamic instance of its material, the glow parameters go there
+	if (UMaterialInstanceDynamic* const Material = WaterBodyComponent->GetWaterMaterialInstance())
+	{
+		Materials.Add(Material);
+		WaterMaterials.Add(Material);
 	}
 }
+
+void ABioluminescentManager::LoadCollisions()
+{
+	// Only the server decides when a collision starts a propagation
+	if (!HasAuthority())
+		return;
+
+	CollisionStream = MakeUnique<FGlowCollisionStream>(*GetWorld(), [this](const UPrimitiveComponent& Component) -> bool
+	{
+		return Participants.Contains(&Component);
+	});
+
+	CollisionStream->MinImpulse = MinHitImpulse;
+}
+
+void ABioluminescentManager::RegisterParticipant(UPrimitiveComponent* const Component)
+{
+	Participants.Add(Component);
+
+	// The landscape spans the whole level and doesn't occlude, covering it would only make the cells coarser
+	if (Occlusion && !Component->IsA<ULandscapeHeightfieldCollisionComponent>())
+		Occlusion->IncludeBounds(Component->Bounds.GetBox());
+
+	// Everything below only changes how the participant looks
+	if (!bRendered)
+		return;
+
+	if (UGlowMushroomFieldComponent* const MushroomField = Cast<UGlowMushroomFieldComponent>(Component))
+		MushroomFields.Add(MushroomField);
+
+	const bool bWritesGlowMask = GlowMask && Component->GetRuntimeVirtualTextures().Contains(GlowMask);
+
+	// Instantiate each material of the component
+	for (int32 i = 0; i < Component->GetNumMaterials(); i++)
+	{
+		UMaterialInstanceDynamic* const Material = Component->CreateDynamicMaterialInstance(i, Component->GetMaterial(i));
+		Materials.Add(Material);
+
+		if (bWritesGlowMask)
+			GlowMaskMaterials.Add(Material);
+	}
+}
+
+void ABioluminescentManager::LoadGlowMask()
+{
+	// Nothing is drawn on a dedicated server or a null RHI run
+	if (!GlowMask || !bRendered)
+		return;
+
+	// The volumes come with the participants, from the manifest or the scan, see LoadParticipants
+	if (GlowMaskVolumes.IsEmpty())
+	{
+		// The materials keep evaluating the points themselves
+		UE_LOG(LogBioluminescence, Warning, TEXT("No volume draws the glow mask %s"), *GlowMask->GetName());
+		return;
+	}
+
+	for (UMaterialInstanceDynamic* const Material : GlowMaskMaterials)
+		Material->SetScalarParameterValue(TEXT("UseGlowMask"), 1.f);
+}
 #pragma endregion
 
 void ABioluminescentManager::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	// Picks up scalability changes, the tick function accumulates the time in between
+	const float UpdateInterval = GlowScalability::GetUpdateInterval();
+	if (GetActorTickInterval() != UpdateInterval)
+		SetActorTickInterval(UpdateInterval);
 	
 	UpdatePlayerMovementCollision(DeltaTime);
+	UpdateCollisionContacts();
+	UpdateHandContacts();
+	UpdateRipples(DeltaTime);
 
-	if (Materials.Num() == 0)
+	if (Participants.IsEmpty())
 	{
-		// Don't want to do anything if the material isn't valid
+		// Don't want to do anything if nothing can glow
 		return;
 	}
-	
+
+	// Only one simulation at a time, the previous one normally completed at the end of the last frame
+	CompleteSimulation();
+
+	// Everything the simulation reads from the world is captured here, it only touches the points afterwards
+	StartPendingPropagations();
+
+	const ULuminescentSignificanceSubsystem* const Significance = GetWorld()->GetSubsystem<ULuminescentSignificanceSubsystem>();
+
+	SimulationInput.DeltaTime = DeltaTime;
+	SimulationInput.MaxLivePoints = GlowScalability::GetMaxManagerPoints(MaxNumberPropagationPoints);
+	for (size_t i = 0; i < PropagationPoints.size(); i++)
+	{
+		const FPropagationPointStatus& p = PropagationPoints[i];
+		const bool bLive = p.Stage != EPropagationStage::Inactive;
+		SimulationInput.PointIntervals[i] = bLive && Significance ? Significance->GetTierInterval(Significance->GetGazeTier(p.HitPoint)) : 0.f;
+	}
+
+	bSimulationPending = true;
+
+	if (bAsyncSimulation)
+	{
+		// Completed by SimulationTickFunction, whatever ticks in between runs alongside it
+		SimulationTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]() -> void { Simulate(); });
+	}
+	else
+	{
+		Simulate();
+		CompleteSimulation();
+	}
+}
+
+void ABioluminescentManager::Simulate()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ManagerSimulation);
+
 	for (size_t i = 0; i < PropagationPoints.size(); i++)
 	{
 		FPropagationPointStatus& p = PropagationPoints[i];
 		//UE_LOG(LogTemp, Display, TEXT("Point %llu: Stage : %lld | Timer : %f"),i,p.Stage, p.PropagationTime);
 		// Easing functions from https://easings.net/en
 
-		// First update the propagation point
-		switch (p.Stage)
+		if (p.Stage == EPropagationStage::Inactive)
+			continue;
+
+		// Points away from the gaze wait for their tier interval, then catch up on the time they skipped
+		p.PendingTime += SimulationInput.DeltaTime;
+		if (p.PendingTime < SimulationInput.PointIntervals[i])
 		{
-			case EPropagationStage::Inactive:
-				break;
+			INC_DWORD_STAT(STAT_DeferredManagerPoints);
+			continue;
+		}
+
+		const float PointDeltaTime = p.PendingTime;
+		p.PendingTime = 0.f;
+
+		const EPropagationStage PreviousStage = p.Stage;
 
+		// First update the propagation point, inactive ones were skipped above
+		switch (p.Stage)
+		{
 			case EPropagationStage::Active:
-				ProcessPropagation(p, DeltaTime);
+				ProcessPropagation(p, PointDeltaTime);
 				break;
 
 			case EPropagationStage::WaitingForFadeOut:
-				p.FadeOutTimer -= DeltaTime;
+				p.FadeOutTimer -= PointDeltaTime;
 				if (p.FadeOutTimer <= 0)
 					p.Stage = EPropagationStage::FadeOut;
 				break;
 
 			case EPropagationStage::FadeOut:
-				ProcessFadeOut(p, DeltaTime);
+				ProcessFadeOut(p, PointDeltaTime);
+		}
+
+		if (p.Stage != PreviousStage)
+		{
+			TRACE_GLOW_STAGE_CHANGE(*this, i, p.Stage);
 		}
 
 		//UE_LOG(LogTemp, Display, TEXT("Point %d: time : %f Stage : %lld (%f, %f, %f)"), i, p.TimeToSend, p.Stage, p.HitPoint.X, p.HitPoint.Y, p.HitPoint.Z);
 	}
 
-	// Send data to the textures
-	SendPointsToShader();
-	SendTimesToShader();
+	MergeOverlappingPoints();
+	UpdateGlowField();
 
-	for (const auto Material : Materials)
-	{
-		Material->SetTextureParameterValue("PointsArray", PointsTexture);
-		Material->SetTextureParameterValue("TimesArray", TimesTexture);
-	}
+	// Send data to the textures, if anything draws them
+	if (PointBuffer)
+		SendPointsToShader();
+}
+
+void ABioluminescentManager::CompleteSimulation()
+{
+	if (!bSimulationPending)
+		return;
+
+	SimulationTask.Wait();
+	bSimulationPending = false;
+
+	// Queries only ever read the field of the last completed simulation
+	Swap(GlowField, SimulatedGlowField);
+
+	// Both drive components, so they stay on the game thread
+	UpdateLightPool(SimulationInput.DeltaTime);
+	UpdateGlowMask();
+}
+
+void FGlowSimulationTickFunction::ExecuteTick(
+	const float,
+	const ELevelTick,
+	const ENamedThreads::Type,
+	const FGraphEventRef&
+)
+{
+	if (Manager && IsValid(Manager))
+		Manager->CompleteSimulation();
+}
+
+FString FGlowSimulationTickFunction::DiagnosticMessage()
+{
+	return TEXT("FGlowSimulationTickFunction");
 }
 
 void ABioluminescentManager::OnHit(
-	UPrimitiveComponent* const,
+	UPrimitiveComponent* const HitComponent,
 	AActor* const OtherActor,
 	UPrimitiveComponent* const,
 	const FVector,
 	const FHitResult& Hit
 )
 {
-	if (IgnoreCollision)
-		return;
-
 	// UE_LOG(LogTemp, Display, TEXT("Hit"));
+	TRACE_GLOW_HIT(*this, Player);
+
+	StartCollisionPropagation(Hit.Location, OtherActor, WaterParticipants.Contains(HitComponent), FindProfileIndex(HitComponent, &Hit));
+}
+
+void ABioluminescentManager::OnWaterOverlap(
+	UPrimitiveComponent* const OverlappedComponent,
+	AActor* const OtherActor,
+	UPrimitiveComponent* const,
+	const int32,
+	const bool bFromSweep,
+	const FHitResult& SweepResult
+)
+{
+	TRACE_GLOW_HIT(*this, Water);
+
+	// Once the actor is inside the volume its closest point is the actor itself, the glow starts on the surface above it
+	const FVector EntryPoint = bFromSweep ? FVector(SweepResult.ImpactPoint) : OtherActor->GetActorLocation();
+	FVector SurfacePoint = EntryPoint;
+
+	const AWaterBody* const WaterBody = Cast<AWaterBody>(OverlappedComponent->GetOwner());
+	if (const UWaterBodyComponent* const WaterBodyComponent = WaterBody ? WaterBody->GetWaterBodyComponent() : nullptr)
+	{
+		FVector SurfaceNormal;
+		FVector WaterVelocity;
+		float WaterDepth;
+		WaterBodyComponent->GetWaterSurfaceInfoAtLocation(EntryPoint, SurfacePoint, SurfaceNormal, WaterVelocity, WaterDepth);
+	}
+	else if (!bFromSweep)
+		OverlappedComponent->GetClosestPointOnCollision(EntryPoint, SurfacePoint);
 
-	const FVector BodyPoint = Hit.Location;
+	StartCollisionPropagation(SurfacePoint, OtherActor, true, FindProfileIndex(OverlappedComponent, bFromSweep ? &SweepResult : nullptr));
+}
 
-	const float MaxRange = OtherActor->GetTransform().GetTranslation().Length() * IntensityRatio;
+void ABioluminescentManager::StartCollisionPropagation(
+	const FVector& StartPoint,
+	const AActor* const OtherActor,
+	const bool bOnWater,
+	const uint8 ProfileIndex
+)
+{
+	// The server is the only one deciding when a propagation starts, clients get it through the multicast
+	if (!HasAuthority())
+		return;
 
-	TryStartPropagation(BodyPoint, MaxRange);
+	if (IgnoreCollision)
+	{
+		TRACE_GLOW_HIT_DROPPED(*this, Ignored);
+		return;
+	}
+
+	const float MaxRange = OtherActor->GetTransform().GetTranslation().Length() * GetProfile(ProfileIndex).IntensityRatio;
+
+	MulticastStartPropagation(FPropagationEvent(StartPoint, MaxRange, bOnWater, ProfileIndex).Quantize());
 	IgnoreCollision = true;
 
 	FTimerHandle Handle;
@@ -192,61 +705,62 @@ void ABioluminescentManager::OnHit(
 void ABioluminescentManager::SetupRenderTarget()
 {
 	// Allocate a texture big enough to hold our max number of points
+	// Positions need full floats, the times can go down to half floats on cheaper platforms
+	const bool bHalfPrecisionTimes = GlowScalability::UseHalfPrecisionTimes();
 	PointsTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, RTF_RGBA32f); 
-	TimesTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, RTF_RGBA32f);
-}
+	TimesTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, bHalfPrecisionTimes ? RTF_RGBA16f : RTF_RGBA32f);
 
-void ABioluminescentManager::SendPointsToShader()
-{
-	SendToShader(PointsTexture, [](const FPropagationPointStatus& Point) -> FLinearColor
-	{
-		constexpr FLinearColor ColorEmpty = FLinearColor(-1.f, -1.f, -1.f, -1.f);
-
-		return Point.Stage != EPropagationStage::Inactive
-			? FLinearColor(Point.HitPoint.X, Point.HitPoint.Y, Point.HitPoint.Z, 1.0f)
-			: ColorEmpty;
-	});
-}
-
-void ABioluminescentManager::SendTimesToShader()
-{
-	SendToShader(TimesTexture, [](const FPropagationPointStatus& Point) -> FLinearColor
-	{
-		constexpr FLinearColor ColorEmpty = FLinearColor(-1.f, -1.f, -1.f, -1.f);
+	// Shared with every glow using the same curves, only a world without the subsystem gets a texture of its own
+	UGlowCurveSubsystem* const Curves = GetWorld()->GetSubsystem<UGlowCurveSubsystem>();
+	CurvesTexture = Curves
+		? Curves->GetTexture(PropagationCurve, FadeOutCurve, PropagationTable, FadeOutTable)
+		: FGlowCurveTable::CreateTexture(PropagationTable, FadeOutTable);
 
-		return Point.Stage != EPropagationStage::Inactive
-			? FLinearColor(Point.TimeToSend, Point.FadeOutIntensity, Point.PropagationDistance, 0.0f)
-			: ColorEmpty;
-	});
+	PointBuffer = FGlowPointBuffer::Create(PointsTexture, TimesTexture, MaxNumberPropagationPoints, bHalfPrecisionTimes);
 }
 
-void ABioluminescentManager::SendToShader(UTextureRenderTarget2D* const Texture, const std::function<FLinearColor(const FPropagationPointStatus&)>& Lambda)
+void ABioluminescentManager::SendPointsToShader()
 {
-	FVector2D _;
-	FDrawToRenderTargetContext Context;
+	// Only a copy into the snapshot happens here, the upload itself is done by the render thread
+	FGlowPointBuffer::FSnapshot& Snapshot = PointBuffer->GetWriteSnapshot();
+	uint32 NumLivePoints = 0;
 
-	UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, Texture, TimesCanvas, _, Context);
-	UKismetRenderingLibrary::ClearRenderTarget2D(this, Texture);
-	
 	for (size_t i = 0; i < PropagationPoints.size(); i++)
 	{
 		const FPropagationPointStatus& p = PropagationPoints[i];
 
-		if (p.Stage != EPropagationStage::Inactive)
+		if (p.Stage == EPropagationStage::Inactive)
 		{
-			// Get result data
-			const FLinearColor Data = Lambda(p);
-
-			// Write color to texture
-			TimesCanvas->K2_DrawBox(FVector2d(i + 0.5f, 0.f), FVector2D::One(), 1.f , Data);
+			Snapshot.Points[i] = FGlowPointBuffer::EmptyTexel;
+			Snapshot.Times[i] = FGlowPointBuffer::EmptyTexel;
+			continue;
 		}
+
+		// A live point keeps a non zero alpha, as cleared texels are 0, the material reads the profile as alpha - 1
+		Snapshot.Points[i] = FVector4f(p.HitPoint.X, p.HitPoint.Y, p.HitPoint.Z, p.ProfileIndex + 1.0f);
+		Snapshot.Times[i] = FVector4f(p.TimeToSend, p.FadeOutIntensity, p.PropagationDistance, 0.0f);
+		NumLivePoints++;
 	}
 
-	UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+	PointBuffer->Publish();
+	TRACE_GLOW_UPLOAD(*this, NumLivePoints);
+}
+
+const FGlowPropagationProfile& ABioluminescentManager::GetProfile(const uint8 ProfileIndex) const
+{
+	return ProfileIndex == 0 || !ProfileSet ? OwnProfile : ProfileSet->GetProfile(ProfileIndex);
+}
+
+uint8 ABioluminescentManager::FindProfileIndex(const UPrimitiveComponent* const Component, const FHitResult* const Hit) const
+{
+	return ProfileSet ? ProfileSet->FindProfileIndex(UGlowProfileSet::ResolvePhysicalMaterial(Component, Hit)) : 0;
 }
 
 void ABioluminescentManager::UpdatePlayerMovementCollision(const float DeltaTime)
 {
+	if (!PlayerMovement)
+		return;
+
 	const bool Airborne = !PlayerMovement->IsMovingOnGround();
 	const float Acceleration = PlayerMovement->GetCurrentAcceleration().SquaredLength();
 
@@ -261,45 +775,369 @@ void ABioluminescentManager::UpdatePlayerMovementCollision(const float DeltaTime
 	if (PlayerMovementTimer >= .5f)
 	{
 		// Hardcode 5k intensity, looks good
-		TryStartPropagation(PlayerMovement->GetActorLocation(), 5000.f);
+		TRACE_GLOW_HIT(*this, Player);
+		StartPropagation(PlayerMovement->GetActorLocation(), 5000.f);
 		PlayerMovementTimer = 0.f;
 	}
 }
 
-void ABioluminescentManager::TryStartPropagation(const FVector& StartPoint, const float MaxRange)
+void ABioluminescentManager::UpdateCollisionContacts()
 {
-	for (size_t i = 0; i < PropagationPoints.size(); i++)
+	if (!CollisionStream)
+		return;
+
+	CollisionStream->Consume(CollisionContacts);
+
+	for (const FGlowCollisionStream::FContact& Contact : CollisionContacts)
+	{
+		const AActor* const OtherActor = Contact.OtherComponent ? Contact.OtherComponent->GetOwner() : nullptr;
+		if (!OtherActor)
+			continue;
+
+		TRACE_GLOW_HIT(*this, Collision);
+		StartCollisionPropagation(Contact.Location, OtherActor, WaterParticipants.Contains(Contact.Component), FindProfileIndex(Contact.Component));
+	}
+}
+
+void ABioluminescentManager::UpdateHandContacts()
+{
+	if (!HandContacts)
+		return;
+
+	const auto IsParticipant = [this](const UPrimitiveComponent& Component) -> bool
+	{
+		if (Participants.Contains(&Component))
+			return true;
+
+		const ALuminescentObject* const LuminescentObject = Cast<ALuminescentObject>(Component.GetOwner());
+		return LuminescentObject && LuminescentObject->MeshComponent == &Component;
+	};
+
+	// All the joints are tested in one go, and only new touches come out of it
+	HandContacts->Detect(*GetWorld(), GetWorld()->GetTimeSeconds(), IsParticipant, HandContactsThisFrame);
+
+	for (const FHandContactDetector::FContact& Contact : HandContactsThisFrame)
 	{
-		if (PropagationPoints[i].Stage == EPropagationStage::Inactive)
+		if (ALuminescentObject* const LuminescentObject = Cast<ALuminescentObject>(Contact.Component->GetOwner()))
 		{
-			SetupPropagationPoint(StartPoint, PropagationPoints[i], MaxRange);
-			break;
+			TRACE_GLOW_HIT(*LuminescentObject, Hand);
+			const uint8 ProfileIndex = LuminescentObject->FindProfileIndex(Contact.Component);
+			LuminescentObject->StartPropagation(Contact.Point, HandContactRange * LuminescentObject->GetProfile(ProfileIndex).IntensityRatio, ProfileIndex);
 		}
+		else
+		{
+			TRACE_GLOW_HIT(*this, Hand);
+			const uint8 ProfileIndex = FindProfileIndex(Contact.Component);
+			StartPropagation(Contact.Point, HandContactRange * GetProfile(ProfileIndex).IntensityRatio, WaterParticipants.Contains(Contact.Component), ProfileIndex);
+		}
+	}
+}
+
+void ABioluminescentManager::UpdateRipples(const float DeltaTime)
+{
+	if (!Ripples)
+		return;
+
+	// The window follows the player whenever the water around it is calm
+	const FVector Center = PlayerMovement ? PlayerMovement->GetActorLocation() : GetActorLocation();
+	if (Ripples->Recenter(Center))
+	{
+		for (UMaterialInstanceDynamic* const Material : WaterMaterials)
+			Material->SetVectorParameterValue("RippleWindow", Ripples->GetWindow());
+	}
+
+	Ripples->Advance(DeltaTime);
+	Ripples->Upload(RippleTexture);
+}
+
+void ABioluminescentManager::UpdateLightPool(const float DeltaTime)
+{
+	// Nothing is lit on a dedicated server or a null RHI run
+	if (!bUseLightProxies || !bRendered)
+		return;
+
+	LightSources.Reset();
+	for (const FPropagationPointStatus& p : PropagationPoints)
+	{
+		if (p.Stage == EPropagationStage::Inactive)
+			continue;
+
+		// Fully bright until the fade out, then as bright as the fade leaves it
+		const float Weight = p.Stage == EPropagationStage::FadeOut ? 1.f - p.FadeOutIntensity : 1.f;
+		const float Radius = FMath::Min(p.TimeToSend * GetProfile(p.ProfileIndex).PropagationSpeed, p.PropagationDistance);
+
+		LightSources.Add({ p.HitPoint, Weight, Radius });
 	}
+
+	LightPool->Update(LightSources, DeltaTime);
 }
 
-void ABioluminescentManager::SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange) const
+void ABioluminescentManager::UpdateGlowField()
+{
+	SimulatedGlowField.Reset();
+
+	for (const FPropagationPointStatus& p : PropagationPoints)
+	{
+		if (p.Stage == EPropagationStage::Inactive)
+			continue;
+
+		const FGlowPropagationProfile& Profile = GetProfile(p.ProfileIndex);
+
+		// Same weights as the light pool, bright until the fade out and then as bright as the fade leaves it
+		// Only an approximation of the material, which shapes the front and the falloff on its own
+		const float Fade = p.Stage == EPropagationStage::FadeOut ? 1.f - p.FadeOutIntensity : 1.f;
+		SimulatedGlowField.AddPoint(p.HitPoint, p.TimeToSend * Profile.PropagationSpeed, p.PropagationDistance, Fade * Profile.IntensityRatio);
+	}
+}
+
+float ABioluminescentManager::GetGlowIntensity(const FVector& Location) const
+{
+	if (const FGlowOcclusionField* const Field = Occlusion ? Occlusion->GetField() : nullptr)
+		return GlowField.Sample(Location, *Field);
+
+	return GlowField.Sample(Location);
+}
+
+void ABioluminescentManager::GetGlowIntensities(const TArray<FVector>& Locations, TArray<float>& OutIntensities) const
+{
+	OutIntensities.SetNumUninitialized(Locations.Num());
+
+	if (const FGlowOcclusionField* const Field = Occlusion ? Occlusion->GetField() : nullptr)
+		GlowField.Sample(Locations, OutIntensities, *Field);
+	else
+		GlowField.Sample(Locations, OutIntensities);
+}
+
+void ABioluminescentManager::UpdateGlowMask()
+{
+	if (GlowMaskVolumes.IsEmpty())
+		return;
+
+	for (FPropagationPointStatus& p : PropagationPoints)
+	{
+		float Radius = 0.f;
+		switch (p.Stage)
+		{
+			case EPropagationStage::Inactive:
+				// Cleared once after the point ended
+				Radius = p.MaskedRadius;
+				p.MaskedRadius = 0.f;
+				break;
+
+			case EPropagationStage::WaitingForFadeOut:
+				// Holding still, what is drawn stays valid
+				continue;
+
+			case EPropagationStage::Active:
+			case EPropagationStage::FadeOut:
+				// Points deferred by the gaze haven't changed this frame
+				if (p.PendingTime > 0.f)
+					continue;
+
+				// Also covers what was drawn last time, a merge can move the range
+				Radius = FMath::Min(p.TimeToSend * GetProfile(p.ProfileIndex).PropagationSpeed, p.PropagationDistance);
+				Radius = FMath::Max(Radius, p.MaskedRadius);
+				p.MaskedRadius = Radius;
+				break;
+		}
+
+		if (Radius <= 0.f)
+			continue;
+
+		// Only the pages this sphere touches get redrawn
+		const FBoxSphereBounds Bounds(FSphere(p.HitPoint, Radius));
+		for (URuntimeVirtualTextureComponent* const Volume : GlowMaskVolumes)
+			Volume->Invalidate(Bounds);
+	}
+}
+
+void ABioluminescentManager::StartPropagation(const FVector& StartPoint, const float MaxRange, const bool bOnWater, const uint8 ProfileIndex)
+{
+	// The server shares its propagations, clients only show their own locally
+	// The server simulates the quantized event too, or its glow would drift from what clients show
+	if (HasAuthority())
+		MulticastStartPropagation(FPropagationEvent(StartPoint, MaxRange, bOnWater, ProfileIndex).Quantize());
+	else
+		MulticastStartPropagation_Implementation({ StartPoint, MaxRange, bOnWater, ProfileIndex });
+}
+
+void ABioluminescentManager::MulticastStartPropagation_Implementation(const FPropagationEvent& Event)
+{
+	UE_LOG(LogBioluminescence, Verbose, TEXT("Propagation event at (%s), %lld bits"), *Event.StartPoint.ToString(), Event.GetSerializedBits());
+
+	TryStartPropagation(Event.StartPoint, Event.MaxRange, Event.ProfileIndex);
+	MarkMushroomHit(Event.StartPoint);
+
+	if (Event.bOnWater && Ripples)
+		Ripples->Disturb(Event.StartPoint, RippleStrength);
+}
+
+void ABioluminescentManager::MarkMushroomHit(const FVector& StartPoint)
+{
+	// Resolved from the event on every machine, so the flash needs nothing replicated
+	for (UGlowMushroomFieldComponent* const MushroomField : MushroomFields)
+	{
+		if (!MushroomField->Bounds.GetBox().ExpandBy(MushroomHitRadius).IsInsideOrOn(StartPoint))
+			continue;
+
+		const int32 Instance = MushroomField->FindInstance(StartPoint, MushroomHitRadius);
+		if (Instance != INDEX_NONE)
+		{
+			MushroomField->MarkHit(Instance, GetWorld()->GetTimeSeconds());
+			return;
+		}
+	}
+}
+
+void ABioluminescentManager::TryStartPropagation(const FVector& StartPoint, const float MaxRange, const uint8 ProfileIndex)
+{
+	// The simulation may be running on its task, the start waits until the next one is prepared
+	PendingStarts.Add({ StartPoint, MaxRange, ProfileIndex });
+}
+
+void ABioluminescentManager::StartPendingPropagations()
+{
+	const size_t MaxLivePoints = GlowScalability::GetMaxManagerPoints(MaxNumberPropagationPoints);
+	size_t NextSlot = 0;
+
+	for (const FPendingStart& Start : PendingStarts)
+	{
+		// Slots before the last one given out are known to be taken
+		while (NextSlot < MaxLivePoints && PropagationPoints[NextSlot].Stage != EPropagationStage::Inactive)
+			NextSlot++;
+
+		if (NextSlot == MaxLivePoints)
+		{
+			TRACE_GLOW_HIT_DROPPED(*this, PoolFull);
+			continue;
+		}
+
+		SetupPropagationPoint(Start.StartPoint, PropagationPoints[NextSlot], Start.MaxRange, Start.ProfileIndex);
+		TRACE_GLOW_POINT_START(*this, NextSlot, Start.ProfileIndex);
+	}
+
+	PendingStarts.Reset();
+}
+
+void ABioluminescentManager::SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange, const uint8 ProfileIndex) const
 {
 	Point.Stage = EPropagationStage::Active;
+	Point.ProfileIndex = ProfileIndex;
 	Point.PropagationTime = 0.f;
+	Point.PendingTime = 0.f;
+	Point.FadeOutHold = 0.f;
+	Point.TimeToSend = 0.f;
+	Point.TotalTime = GetProfile(ProfileIndex).GetTotalPropagationTime();
 	Point.HitPoint = StartPoint;
 	Point.PropagationDistance = MaxRange;
 }
 
+void ABioluminescentManager::MergeOverlappingPoints()
+{
+	const size_t MaxLivePoints = SimulationInput.MaxLivePoints;
+	const size_t MergeThreshold = FMath::CeilToInt(MaxLivePoints * MergeOccupancy);
+
+	size_t NumLivePoints = 0;
+	for (size_t i = 0; i < MaxLivePoints; i++)
+	{
+		if (PropagationPoints[i].Stage != EPropagationStage::Inactive)
+			NumLivePoints++;
+	}
+
+	// Merging is only worth its cost, and its approximation, when the pool is running out of slots
+	if (NumLivePoints == 0 || NumLivePoints < MergeThreshold)
+		return;
+
+	for (size_t i = 0; i < MaxLivePoints && NumLivePoints >= MergeThreshold; i++)
+	{
+		if (PropagationPoints[i].Stage != EPropagationStage::Active)
+			continue;
+
+		for (size_t j = i + 1; j < MaxLivePoints; j++)
+		{
+			FPropagationPointStatus& First = PropagationPoints[i];
+			FPropagationPointStatus& Second = PropagationPoints[j];
+
+			// Only points following the same profile share their timing
+			if (Second.Stage != EPropagationStage::Active || Second.ProfileIndex != First.ProfileIndex)
+				continue;
+
+			const bool bFirstOlder = First.PropagationTime + First.PendingTime >= Second.PropagationTime + Second.PendingTime;
+			FPropagationPointStatus& Older = bFirstOlder ? First : Second;
+			FPropagationPointStatus& Younger = bFirstOlder ? Second : First;
+
+			if (!CanMergePoints(Older, Younger))
+				continue;
+
+			MergePoints(Older, Younger);
+			TRACE_GLOW_POINT_EVICT(*this, bFirstOlder ? j : i, bFirstOlder ? i : j);
+			NumLivePoints--;
+			INC_DWORD_STAT(STAT_MergedManagerPoints);
+
+			// The point the outer loop is on is gone
+			if (!bFirstOlder)
+				break;
+		}
+	}
+}
+
+bool ABioluminescentManager::CanMergePoints(const FPropagationPointStatus& Older, const FPropagationPointStatus& Younger) const
+{
+	const float Speed = GetProfile(Older.ProfileIndex).PropagationSpeed;
+	const float OlderFront = Older.TimeToSend * Speed;
+	const float YoungerFront = Younger.TimeToSend * Speed;
+
+	const float Distance = FVector::Dist(Older.HitPoint, Younger.HitPoint);
+
+	// A point that hasn't spread yet only needs to have started inside the older front
+	if (YoungerFront <= UE_KINDA_SMALL_NUMBER)
+		return Distance <= OlderFront;
+
+	// Part of the younger front diameter that lies inside the older front, along the line between the centres
+	const float CoveredDiameter = FMath::Min(OlderFront - Distance + YoungerFront, 2.f * YoungerFront);
+	return CoveredDiameter >= 2.f * YoungerFront * MergeOverlap;
+}
+
+void ABioluminescentManager::MergePoints(FPropagationPointStatus& Older, FPropagationPointStatus& Younger) const
+{
+	// The older point keeps its centre and its front, and grows its range to still reach as far as the younger one
+	const float Distance = FVector::Dist(Older.HitPoint, Younger.HitPoint);
+	Older.PropagationDistance = FMath::Max(Older.PropagationDistance, Distance + Younger.PropagationDistance);
+
+	// The front only spreads for as long as the point propagates, so it propagates for longer too,
+	// until its front goes past the far edge of the younger one
+	const float Speed = GetProfile(Older.ProfileIndex).PropagationSpeed;
+	Older.TotalTime = FMath::Max(Older.TotalTime, Distance / Speed + Younger.TotalTime);
+
+	// It also stays lit until the younger one would have started fading out
+	const float OlderRemainingTime = Older.TotalTime - (Older.PropagationTime + Older.PendingTime);
+	const float YoungerRemainingTime = Younger.TotalTime - (Younger.PropagationTime + Younger.PendingTime);
+	Older.FadeOutHold = FMath::Max(Older.FadeOutHold, Younger.FadeOutHold + YoungerRemainingTime - OlderRemainingTime);
+
+	Younger.Stage = EPropagationStage::Inactive;
+	Younger.PropagationTime = 0.f;
+	Younger.PendingTime = 0.f;
+	Younger.TimeToSend = 0.f;
+	Younger.FadeOutIntensity = 0.f;
+}
+
 void ABioluminescentManager::ProcessPropagation(FPropagationPointStatus& Point, const float DeltaTime) const
 {
+	const FGlowPropagationProfile& Profile = GetProfile(Point.ProfileIndex);
+	const float TotalTime = Point.TotalTime;
+
 	Point.PropagationTime += DeltaTime;
 
-	const float TimeRate = Point.PropagationTime / TotalPropagationTime;
-	Point.TimeToSend = UKismetMathLibrary::Ease(0, TotalPropagationTime, TimeRate, EEasingFunc::EaseOut, 3);
+	const float TimeRate = Point.PropagationTime / TotalTime;
+	Point.TimeToSend = TotalTime * PropagationTable.Evaluate(TimeRate);
 
-	// Hacky fix to the long "pause" at the end due to the values very slowly reaching the max
-	// This "interrupts" the fade and jumps straight to the end, ignoring the very subtle changes
-	if (Point.TimeToSend >= TotalPropagationTime * .99f)
+	// Ends with the curve, whatever its shape, so the front never jumps to its last value
+	if (TimeRate >= 1.f)
 	{
-		Point.PropagationTime = Point.TimeToSend;
-		Point.PropagationEndTime = Point.TimeToSend;
+		Point.PropagationTime = TotalTime;
+		Point.PropagationEndTime = TotalTime;
 
+		const float FadeOutDelay = Profile.FadeOutDelay + Point.FadeOutHold;
 		if (FadeOutDelay > 0.f)
 		{
 			// A fade out timer is necessary, so set up an unreal timer
@@ -316,12 +1154,15 @@ void ABioluminescentManager::ProcessPropagation(FPropagationPointStatus& Point,
 
 void ABioluminescentManager::ProcessFadeOut(FPropagationPointStatus& Point, const float DeltaTime) const
 {
+	const FGlowPropagationProfile& Profile = GetProfile(Point.ProfileIndex);
+	const float TotalTime = Point.TotalTime;
+
 	// The fade out is done by simply doing the propagation in reverse order
 	Point.PropagationTime += DeltaTime;
 	
-	Point.FadeOutIntensity = FMath::Clamp( (Point.PropagationTime - TotalPropagationTime) / FadeOutDuration, 0, 1);
+	Point.FadeOutIntensity = FadeOutTable.Evaluate((Point.PropagationTime - TotalTime) / Profile.FadeOutDuration);
 
-	if (Point.PropagationTime >= TotalPropagationTime + FadeOutDuration)
+	if (Point.PropagationTime >= TotalTime + Profile.FadeOutDuration)
 	{
 		Point.PropagationTime = 0.0f;
 		Point.FadeOutIntensity = 0.0f;
@@ -1,14 +1,53 @@
 #pragma once
 
 #include <array>
-#include <functional>
 
 #include "CoreMinimal.h"
 #include "Tech_Art_SoleilCharacter.h"
 #include "GameFramework/Actor.h"
+#include "GlowCollisionStream.h"
+#include "GlowCurveTable.h"
+#include "GlowField.h"
+#include "GlowLightPoolComponent.h"
+#include "GlowPointBuffer.h"
+#include "GlowProfileSet.h"
+#include "HandContactDetector.h"
+#include "PropagationEvent.h"
+#include "RippleHeightfield.h"
 #include "Kismet/KismetRenderingLibrary.h"
+#include "Tasks/Task.h"
 #include "ABioluminescentManager.generated.h"
 
+class ABioluminescentManager;
+class AWaterBody;
+class UGlowMushroomFieldComponent;
+class UGlowOcclusionSubsystem;
+class URuntimeVirtualTexture;
+class URuntimeVirtualTextureComponent;
+
+/**
+ * Completes the simulation the manager launched earlier in the frame, see ABioluminescentManager::CompleteSimulation
+ */
+USTRUCT()
+struct FGlowSimulationTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	ABioluminescentManager* Manager = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FGlowSimulationTickFunction> : public TStructOpsTypeTraitsBase2<FGlowSimulationTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
 /**
  * 
  */
@@ -44,24 +83,73 @@ class TECH_ART_SOLEIL_API ABioluminescentManager : public AActor
 		float FadeOutTimer;
 		float FadeOutIntensity;
 		float PropagationDistance;
+
+		// Profile the point propagates with, 0 for the own values of the actor
+		uint8 ProfileIndex = 0;
+
+		// Time the point hasn't advanced by yet, points away from the gaze advance less often
+		float PendingTime = 0.f;
+
+		// Added to the fade out delay, so the point stays lit as long as the points merged into it would have
+		float FadeOutHold = 0.f;
+
+		// Time the front takes to spread fully, the one of the profile unless points were merged into this one
+		float TotalTime = 0.f;
+
+		// Radius last redrawn in the glow mask, the area is redrawn once more after the point ends to clear it
+		float MaskedRadius = 0.f;
 	};
 
 	protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	ABioluminescentManager();
 
 	virtual void Tick(float DeltaTime) override;
 
+	// Only bound to the player capsule, whose sweeps never reach the physics scene collision events
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	// Water is usually crossed rather than hit, so entering it starts a propagation too
+	UFUNCTION()
+	void OnWaterOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	// How lit a location currently is, 0 where nothing glows, an approximation of what the glow material draws
+	// The falloff is linear rather than the one of the material, and points behind solid geometry don't count, see FGlowField
+	UFUNCTION(BlueprintPure)
+	float GetGlowIntensity(const FVector& Location) const;
+
+	// Same as GetGlowIntensity for many locations at once, much faster than one call per location
+	UFUNCTION(BlueprintCallable)
+	void GetGlowIntensities(const TArray<FVector>& Locations, TArray<float>& OutIntensities) const;
+
+	// For native queries, can be sampled anywhere on the game thread
+	const FGlowField& GetGlowField() const { return GlowField; }
+
+	// Waits for the simulation launched by Tick, then hands its result to the game thread
+	void CompleteSimulation();
+
+	// Runs the propagation on a background task between Tick and the end of the frame, instead of inline in Tick
+	UPROPERTY(EditAnywhere)
+	bool bAsyncSimulation = true;
+
+	// Starts the propagation on the server and every client, each of them simulates it locally
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastStartPropagation(const FPropagationEvent& Event);
+
 	static constexpr size_t MaxNumberPropagationPoints = 75;
 
+	// Placed mushroom actors, prefer an AGlowMushroomField for dense areas
 	UPROPERTY(EditAnywhere)
 	UClass* MushroomClass = nullptr;
 
+	// How far from a propagation start the mushroom of a field it lands on is looked for
+	UPROPERTY(EditAnywhere)
+	float MushroomHitRadius = 30.f;
+
 	// Ignores collision for a certain amount of time after one happened
 	UPROPERTY(EditAnywhere)
 	float IgnoreCollisionTimer = 0.1f;
@@ -86,24 +174,164 @@ public:
 	UPROPERTY(EditAnywhere)
 	float FadeOutDuration = 1.f;
 
+	// Fraction of the live points in use before overlapping points start being merged
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", ClampMax = "1"))
+	float MergeOccupancy = 0.75f;
+
+	// How much of the front of a younger point has to be inside an older one for them to be merged
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0", ClampMax = "1"))
+	float MergeOverlap = 0.8f;
+
+	// Collisions on participants with a smaller impulse don't start a propagation, in kg.cm/s
+	// The default is a kilogram at a metre per second, resting and brushing contacts stay below it
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0"))
+	float MinHitImpulse = 100.f;
+
+	// Starts propagations where the tracked fingers touch a participant
+	UPROPERTY(EditAnywhere)
+	bool bUseHandContacts = false;
+
+	// Replays this joint stream instead of the tracked hands, see FRecordedHandJointSource::LoadFromFile
+	UPROPERTY(EditAnywhere)
+	FFilePath RecordedHandJoints;
+
+	// Replays fingers tapping on the manager location instead of the tracked hands
+	UPROPERTY(EditAnywhere)
+	bool bUseSyntheticHands = false;
+
+	// How far the bioluminescence propagates from a finger contact
+	UPROPERTY(EditAnywhere)
+	float HandContactRange = 300.f;
+
+	// Size of a cell of the water ripples, the simulated window is FRippleHeightfield::Resolution cells wide
+	UPROPERTY(EditAnywhere)
+	float RippleCellSize = 25.f;
+
+	// How deep a propagation starting on water pushes the surface
+	UPROPERTY(EditAnywhere)
+	float RippleStrength = 10.f;
+
+	// Lights the surroundings of the glow through the light pool, instead of only being emissive
+	UPROPERTY(EditAnywhere)
+	bool bUseLightProxies = false;
+
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UGlowLightPoolComponent> LightPool = nullptr;
+
+	// Participants writing into this virtual texture sample their glow from it, instead of evaluating every point
+	// Only the pages around the live points are redrawn, needs a volume using it in the level
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<URuntimeVirtualTexture> GlowMask = nullptr;
+
+#if WITH_EDITOR
+	// Records the participants of the level, so the runtime loads them instead of scanning the world
+	void BuildManifest();
+#endif
+
+	// Participants recorded by the GlowManifest commandlet, see BuildManifest
+	UPROPERTY(VisibleAnywhere)
+	bool bHasManifest = false;
+
+	UPROPERTY(VisibleAnywhere)
+	TArray<TSoftObjectPtr<UPrimitiveComponent>> ManifestSurfaces;
+
+	UPROPERTY(VisibleAnywhere)
+	TArray<TSoftObjectPtr<UPrimitiveComponent>> ManifestQueryOnly;
+
+	UPROPERTY(VisibleAnywhere)
+	TArray<TSoftObjectPtr<AWaterBody>> ManifestWaterBodies;
+
+	// Volumes drawing the glow mask, see GlowMask
+	UPROPERTY(VisibleAnywhere)
+	TArray<TSoftObjectPtr<URuntimeVirtualTextureComponent>> ManifestGlowMaskVolumes;
+
+	// Signature of the level when the manifest was built, the world is scanned instead once the level no longer matches
+	UPROPERTY(VisibleAnywhere)
+	uint32 ManifestSignature = 0;
+
+	// Profiles of the surfaces that don't propagate with the values above, keyed by physical material
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UGlowProfileSet> ProfileSet = nullptr;
+
+	// Shape of the propagation over time, from 0 to 1 in time and in value, a cubic ease out if not set
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UCurveFloat> PropagationCurve = nullptr;
+
+	// Shape of the fade out over time, from 0 to 1 in time and in value, linear if not set
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UCurveFloat> FadeOutCurve = nullptr;
+
 private:
-	void LoadMushrooms();
-	void LoadRocks();
-	void LoadLandscape();
-	void LoadFoliage();
+	// Everything the glow can start from, found at load or scanned from the world
+	struct FParticipantList final
+	{
+		// Glowing components, their materials are instantiated
+		TArray<UPrimitiveComponent*> Surfaces;
+		// Components only recognised by the queries, like the landscape collision
+		TArray<UPrimitiveComponent*> QueryOnly;
+		TArray<AWaterBody*> WaterBodies;
+		// Volumes drawing the glow mask
+		TArray<URuntimeVirtualTextureComponent*> GlowMaskVolumes;
+	};
+
+	void LoadParticipants();
 	void LoadPlayer();
+	void LoadHands();
+	void LoadCollisions();
+	void LoadGlowMask();
+
+	void ResolveManifest(FParticipantList& List) const;
+
+	// Hash of the names of the level actors the participants are gathered from, stable across saves and cooks
+	uint32 ComputeLevelSignature() const;
+	void GatherParticipants(UWorld& World, FParticipantList& List) const;
+	static void GatherActorType(UWorld& World, const TSubclassOf<AActor>& Class, FParticipantList& List);
 
-	void LoadActorType(const TSubclassOf<AActor>& Class);
+	// Whether the materials read the glow parameters, components that can't glow aren't registered
+	static bool UsesGlowParameters(const UPrimitiveComponent& Component);
+	static bool UsesGlowParameters(const UMaterialInterface* Material);
+
+	// Instantiates the materials of a component the glow can start from, its contacts come from the collision stream
+	void RegisterParticipant(UPrimitiveComponent* Component);
+	void RegisterWaterBody(AWaterBody& WaterBody);
 	
 	void SetupRenderTarget();
 	void SendPointsToShader();
-	void SendTimesToShader();
-	void SendToShader(UTextureRenderTarget2D* Texture, const std::function<FLinearColor(const FPropagationPointStatus&)>& Lambda);
 
 	void UpdatePlayerMovementCollision(float DeltaTime);
+	void UpdateCollisionContacts();
+	void UpdateHandContacts();
+	void UpdateRipples(float DeltaTime);
+	void UpdateLightPool(float DeltaTime);
+	void UpdateGlowMask();
+	void UpdateGlowField();
+
+	// Starts a propagation for a collision with another actor, ignoring the following ones for a while
+	void StartCollisionPropagation(const FVector& StartPoint, const AActor* OtherActor, bool bOnWater, uint8 ProfileIndex);
+
+	// Shared with every client on the server, local only on clients
+	void StartPropagation(const FVector& StartPoint, const float MaxRange, bool bOnWater = false, uint8 ProfileIndex = 0);
 	
-	void TryStartPropagation(const FVector& StartPoint, const float MaxRange);
-	void SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange) const;
+	// Queues the start, points only change when no simulation is running
+	void TryStartPropagation(const FVector& StartPoint, const float MaxRange, uint8 ProfileIndex = 0);
+	void StartPendingPropagations();
+
+	// Advances the points from the captured input, on the simulation task when it is asynchronous
+	void Simulate();
+
+	// Flashes the mushroom instance a propagation starts on, if any
+	void MarkMushroomHit(const FVector& StartPoint);
+	void SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange, uint8 ProfileIndex) const;
+
+	const FGlowPropagationProfile& GetProfile(uint8 ProfileIndex) const;
+
+	// Profile of the surface of a hit, 0 when the profile set has none for it
+	uint8 FindProfileIndex(const UPrimitiveComponent* Component, const FHitResult* Hit = nullptr) const;
+
+	// Folds the active points mostly covered by an older one into it, only when the pool is running out of slots
+	void MergeOverlappingPoints();
+	bool CanMergePoints(const FPropagationPointStatus& Older, const FPropagationPointStatus& Younger) const;
+	void MergePoints(FPropagationPointStatus& Older, FPropagationPointStatus& Younger) const;
 
 	void ProcessPropagation(FPropagationPointStatus& Point, float DeltaTime) const;
 	void ProcessFadeOut(FPropagationPointStatus& Point, float DeltaTime) const;
@@ -114,6 +342,64 @@ private:
 	UPROPERTY()
 	TArray<UMaterialInstanceDynamic*> Materials = {};
 
+	// Components the glow can start from, only used to recognise them
+	TSet<const UPrimitiveComponent*> Participants;
+
+	// Collision components of the water bodies, propagations starting on them also make ripples
+	TSet<const UPrimitiveComponent*> WaterParticipants;
+
+	UPROPERTY()
+	TArray<TObjectPtr<UGlowMushroomFieldComponent>> MushroomFields;
+
+	// Keeps the glow queries from seeing points through walls and rocks
+	UPROPERTY()
+	TObjectPtr<UGlowOcclusionSubsystem> Occlusion = nullptr;
+
+	// Live points as seen by the material, for the glow queries
+	FGlowField GlowField;
+
+	// Written by the simulation, swapped with GlowField once it completes
+	FGlowField SimulatedGlowField;
+
+	struct FPendingStart final
+	{
+		FVector StartPoint;
+		float MaxRange = 0.f;
+		uint8 ProfileIndex = 0;
+	};
+
+	TArray<FPendingStart> PendingStarts;
+
+	// Everything the simulation reads that isn't a point, captured on the game thread before it starts
+	struct FSimulationInput final
+	{
+		float DeltaTime = 0.f;
+		size_t MaxLivePoints = 0;
+
+		// Time each point waits before advancing, from the gaze
+		std::array<float, MaxNumberPropagationPoints> PointIntervals = {};
+	};
+
+	FSimulationInput SimulationInput;
+
+	UE::Tasks::FTask SimulationTask;
+	bool bSimulationPending = false;
+
+	// False on dedicated servers and null RHI runs, only the simulation and the events run then
+	bool bRendered = true;
+
+	FGlowSimulationTickFunction SimulationTickFunction;
+
+	// Kept between frames so feeding the light pool doesn't allocate
+	TArray<UGlowLightPoolComponent::FSource> LightSources;
+
+	// Only on the server
+	TUniquePtr<FGlowCollisionStream> CollisionStream;
+	TArray<FGlowCollisionStream::FContact> CollisionContacts;
+
+	TUniquePtr<FHandContactDetector> HandContacts;
+	TArray<FHandContactDetector::FContact> HandContactsThisFrame;
+
 	UPROPERTY()
 	const UCharacterMovementComponent* PlayerMovement = nullptr;
 	
@@ -125,12 +411,37 @@ private:
 	UPROPERTY()
 	UTextureRenderTarget2D* TimesTexture = nullptr;
 
-	// Canvas to draw to the texture
+	// Texture holding both curves, this is sent to the shader
 	UPROPERTY()
-	UCanvas* PointsCanvas = nullptr;
+	UTexture2D* CurvesTexture = nullptr;
+
+	// Only created when the level has water
+	TUniquePtr<FRippleHeightfield> Ripples;
 
+	// Texture holding the ripple heights, this is sent to the water shaders
 	UPROPERTY()
-	UCanvas* TimesCanvas = nullptr;
+	UTexture2D* RippleTexture = nullptr;
+
+	UPROPERTY()
+	TArray<UMaterialInstanceDynamic*> WaterMaterials = {};
+
+	// Materials of the participants writing into the glow mask
+	UPROPERTY()
+	TArray<UMaterialInstanceDynamic*> GlowMaskMaterials = {};
+
+	// Volumes drawing the glow mask, empty when it isn't used
+	UPROPERTY()
+	TArray<TObjectPtr<URuntimeVirtualTextureComponent>> GlowMaskVolumes = {};
+
+	// The values set on the actor, as a profile
+	FGlowPropagationProfile OwnProfile;
+
+	// Curves baked at load, evaluated by the propagation and the fade out
+	FGlowCurveTable PropagationTable;
+	FGlowCurveTable FadeOutTable;
+
+	// Hands the points over to the render thread, which uploads them to the textures
+	TSharedPtr<FGlowPointBuffer, ESPMode::ThreadSafe> PointBuffer;
 
 	// The total time needed to finish the propagation, based on the distance and speed
 	float TotalPropagationTime = 0.f;
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GazeSource.h"
+
+#include "EyeTrackerFunctionLibrary.h"
+#include "Tech_Art_Soleil.h"
+#include "Algo/BinarySearch.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+
+bool FEyeTrackerGazeSource::GetGaze(UWorld& World, float, FVector& OutOrigin, FVector& OutDirection)
+{
+	if (!UEyeTrackerFunctionLibrary::IsEyeTrackerConnected())
+		return false;
+
+	FEyeTrackerGazeData Data;
+	if (!UEyeTrackerFunctionLibrary::GetGazeData(Data, UGameplayStatics::GetPlayerController(&World, 0)))
+		return false;
+
+	// The runtime reports a zero confidence while the eyes are closed or lost
+	if (Data.ConfidenceValue <= 0.f)
+		return false;
+
+	OutOrigin = Data.GazeOrigin;
+	OutDirection = Data.GazeDirection;
+	return true;
+}
+
+FRecordedGazeSource::FRecordedGazeSource(TArray<FFrame>&& InFrames)
+	: Frames(MoveTemp(InFrames))
+{
+}
+
+TUniquePtr<FRecordedGazeSource> FRecordedGazeSource::LoadFromFile(const FString& Path)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("Could not load the gaze path %s"), *Path);
+		return nullptr;
+	}
+
+	TArray<FFrame> Frames;
+	TArray<FString> Values;
+
+	for (const FString& Line : Lines)
+	{
+		Line.ParseIntoArray(Values, TEXT(","));
+		if (Values.Num() != 3)
+			continue;
+
+		FFrame& Frame = Frames.AddDefaulted_GetRef();
+		Frame.Time = FCString::Atof(*Values[0]);
+		Frame.Offset = FRotator(FCString::Atod(*Values[2]), FCString::Atod(*Values[1]), 0.);
+	}
+
+	if (Frames.IsEmpty())
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("The gaze path %s has no valid frame"), *Path);
+		return nullptr;
+	}
+
+	return MakeUnique<FRecordedGazeSource>(MoveTemp(Frames));
+}
+
+bool FRecordedGazeSource::GetGaze(UWorld& World, const float Time, FVector& OutOrigin, FVector& OutDirection)
+{
+	const APlayerCameraManager* const Camera = UGameplayStatics::GetPlayerCameraManager(&World, 0);
+	if (!Camera)
+		return false;
+
+	// Frames are sorted by time, and a path always loops one frame duration after its last frame
+	const float FrameDuration = Frames.Num() > 1 ? Frames[1].Time - Frames[0].Time : 1.f;
+	const float Duration = Frames.Last().Time - Frames[0].Time + FrameDuration;
+	const float LoopTime = Frames[0].Time + FMath::Fmod(Time, Duration);
+
+	const int32 Index = FMath::Max(Algo::UpperBoundBy(Frames, LoopTime, &FFrame::Time) - 1, 0);
+
+	OutOrigin = Camera->GetCameraLocation();
+	OutDirection = Camera->GetCameraRotation().Quaternion() * Frames[Index].Offset.Vector();
+	return true;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Provides where the player is looking, once per frame
+ */
+class IGazeSource
+{
+public:
+	virtual ~IGazeSource() = default;
+
+	// World space gaze ray, false if no gaze is available this frame
+	virtual bool GetGaze(UWorld& World, float Time, FVector& OutOrigin, FVector& OutDirection) = 0;
+};
+
+/**
+ * Gaze of the player, as tracked by the eye tracker of the headset
+ */
+class FEyeTrackerGazeSource final : public IGazeSource
+{
+public:
+	virtual bool GetGaze(UWorld& World, float Time, FVector& OutOrigin, FVector& OutDirection) override;
+};
+
+/**
+ * Replays a recorded gaze path relative to the player camera, so the foveation can be measured without any headset
+ */
+class FRecordedGazeSource final : public IGazeSource
+{
+public:
+	struct FFrame final
+	{
+		float Time = 0.f;
+		// Offset of the gaze from the view direction, in degrees
+		FRotator Offset;
+	};
+
+	explicit FRecordedGazeSource(TArray<FFrame>&& InFrames);
+
+	// Loads a path with one frame per line: the time, then the yaw and pitch offsets from the view, comma separated
+	static TUniquePtr<FRecordedGazeSource> LoadFromFile(const FString& Path);
+
+	// Loops over the path, holding each frame until the next one starts
+	virtual bool GetGaze(UWorld& World, float Time, FVector& OutOrigin, FVector& OutDirection) override;
+
+private:
+	TArray<FFrame> Frames;
+};
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowCollisionStream.h"
+
+#include "EventManager.h"
+#include "EventsData.h"
+#include "PBDRigidsSolver.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+
+FGlowCollisionStream::FGlowCollisionStream(UWorld& World, TFunction<bool(const UPrimitiveComponent&)>&& InIsParticipant)
+	: Scene(World.GetPhysicsScene())
+	, IsParticipant(MoveTemp(InIsParticipant))
+{
+	Chaos::FPBDRigidsSolver* const Solver = Scene ? Scene->GetSolver() : nullptr;
+	if (!Solver)
+		return;
+
+	// The solver only gathers the collision data when someone listens to it
+	Solver->EnqueueCommandImmediate([Solver]() -> void { Solver->SetGenerateCollisionData(true); });
+
+	Solver->GetEventManager()->RegisterHandler<Chaos::FCollisionEventData>(
+		Chaos::EEventType::Collision, this, &FGlowCollisionStream::HandleCollisionEvents);
+}
+
+FGlowCollisionStream::~FGlowCollisionStream()
+{
+	Chaos::FPBDRigidsSolver* const Solver = Scene ? Scene->GetSolver() : nullptr;
+	if (Solver)
+		Solver->GetEventManager()->UnregisterHandler(Chaos::EEventType::Collision, this);
+}
+
+void FGlowCollisionStream::Consume(TArray<FContact>& OutContacts)
+{
+	// Both arrays keep their allocation, the stream fills the one the glow consumed last time
+	Swap(OutContacts, Contacts);
+	Contacts.Reset();
+}
+
+void FGlowCollisionStream::HandleCollisionEvents(const Chaos::FCollisionEventData& Event)
+{
+	const float MinImpulseSquared = FMath::Square(MinImpulse);
+
+	// Both maps keep their allocation, this tick overwrites the pairs of the one before last
+	Swap(PairContacts, PreviousPairContacts);
+	PairContacts.Reset();
+
+	for (const Chaos::FCollidingData& Collision : Event.CollisionData.AllCollisionsArray)
+	{
+		UPrimitiveComponent* const Component1 = Scene->GetOwningComponent<UPrimitiveComponent>(Collision.Proxy1);
+		UPrimitiveComponent* const Component2 = Scene->GetOwningComponent<UPrimitiveComponent>(Collision.Proxy2);
+
+		const bool bParticipant1 = Component1 && IsParticipant(*Component1);
+		const bool bParticipant2 = Component2 && IsParticipant(*Component2);
+		if (!bParticipant1 && !bParticipant2)
+			continue;
+
+		// Same key whichever way round the solver reports the pair
+		const FComponentPair Pair = Component1 < Component2 ? FComponentPair(Component1, Component2) : FComponentPair(Component2, Component1);
+
+		// Every touching pair is remembered whatever its impulse, or a resting contact hovering around the threshold
+		// would come back as a new one each time it crosses it
+		int32* Index = PairContacts.Find(Pair);
+		if (!Index)
+			Index = &PairContacts.Add(Pair, INDEX_NONE);
+
+		// Still touching since the last tick, it was new back then
+		if (PreviousPairContacts.Contains(Pair))
+			continue;
+
+		if (Collision.AccumulatedImpulse.SizeSquared() < MinImpulseSquared)
+			continue;
+
+		const float Impulse = Collision.AccumulatedImpulse.Size();
+
+		// Several constraints between the same pair, only the strongest one is kept
+		if (*Index != INDEX_NONE)
+		{
+			if (Contacts[*Index].Impulse < Impulse)
+			{
+				Contacts[*Index].Location = Collision.Location;
+				Contacts[*Index].Impulse = Impulse;
+			}
+
+			continue;
+		}
+
+		*Index = Contacts.Num();
+
+		FContact& Contact = Contacts.AddDefaulted_GetRef();
+		Contact.Location = Collision.Location;
+		Contact.Impulse = Impulse;
+		Contact.Component = bParticipant1 ? Component1 : Component2;
+		Contact.OtherComponent = bParticipant1 ? Component2 : Component1;
+	}
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FPhysScene_Chaos;
+class UPrimitiveComponent;
+class UWorld;
+
+namespace Chaos
+{
+	struct FCollisionEventData;
+}
+
+/**
+ * Collects the contacts of the glow participants from the collision events of the physics scene
+ *
+ * A single handler receives every collision of the frame, filters them in one pass on the participants and
+ * on the impulse, and keeps a compact contact for each one until the glow consumes them
+ * Only new contacts count, a pair of components touching on the previous physics tick too is resting or sliding,
+ * and a pair touching in several places on the same tick is a single contact, the strongest one
+ * This replaces a hit delegate per component, which copied a full hit result for every contact
+ */
+class FGlowCollisionStream final
+{
+public:
+	struct FContact final
+	{
+		FVector Location;
+		float Impulse = 0.f;
+		// The participant that was hit
+		UPrimitiveComponent* Component = nullptr;
+		// What hit it, can be a component that isn't a participant
+		UPrimitiveComponent* OtherComponent = nullptr;
+	};
+
+	FGlowCollisionStream(UWorld& World, TFunction<bool(const UPrimitiveComponent&)>&& InIsParticipant);
+	~FGlowCollisionStream();
+
+	// Contacts received since the last call, the stream starts empty again
+	void Consume(TArray<FContact>& OutContacts);
+
+	// Contacts with a smaller impulse are dropped, in kg.cm/s as Chaos measures them
+	float MinImpulse = 0.f;
+
+private:
+	using FComponentPair = TPair<const UPrimitiveComponent*, const UPrimitiveComponent*>;
+
+	void HandleCollisionEvents(const Chaos::FCollisionEventData& Event);
+
+	FPhysScene_Chaos* Scene = nullptr;
+	TFunction<bool(const UPrimitiveComponent&)> IsParticipant;
+
+	TArray<FContact> Contacts;
+
+	// Pairs in contact on this physics tick and on the previous one, with the index of their contact for this one
+	// The components are only compared, never accessed, so they don't need to be alive anymore
+	TMap<FComponentPair, int32> PairContacts;
+	TMap<FComponentPair, int32> PreviousPairContacts;
+};
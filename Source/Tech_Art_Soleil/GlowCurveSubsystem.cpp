@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowCurveSubsystem.h"
+
+#include "Tech_Art_Soleil.h"
+#include "Curves/CurveFloat.h"
+#include "Engine/Texture2D.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Glow curve textures"), STAT_GlowCurveTextures, STATGROUP_Bioluminescence);
+
+void UGlowCurveSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_GlowCurveTextures, Textures.Num());
+
+	TexturesByCurves.Reset();
+	Textures.Reset();
+
+	Super::Deinitialize();
+}
+
+UTexture2D* UGlowCurveSubsystem::GetTexture(const UCurveFloat* const RiseCurve, const UCurveFloat* const FadeCurve, const FGlowCurveTable& Rise, const FGlowCurveTable& Fade)
+{
+	const FCurvePair Key(RiseCurve, FadeCurve);
+	if (UTexture2D* const* const Found = TexturesByCurves.Find(Key))
+		return *Found;
+
+	UTexture2D* const Texture = FGlowCurveTable::CreateTexture(Rise, Fade);
+	if (!Texture)
+		return nullptr;
+
+	TexturesByCurves.Add(Key, Texture);
+	Textures.Add(Texture);
+	INC_DWORD_STAT(STAT_GlowCurveTextures);
+
+	return Texture;
+}
+
+bool UGlowCurveSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
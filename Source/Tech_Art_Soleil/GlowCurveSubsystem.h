@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlowCurveTable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "GlowCurveSubsystem.generated.h"
+
+class UCurveFloat;
+class UTexture2D;
+
+/**
+ * Owns the curve textures of the world, one per pair of rise and fade curves
+ *
+ * Every glow using the same curves binds the same texture, instead of uploading an identical one of its own
+ */
+UCLASS()
+class TECH_ART_SOLEIL_API UGlowCurveSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Texture of the curve pair, created from the tables the first time the pair is asked for
+	// The tables must be baked from these curves, so any caller's tables make the same texture
+	UTexture2D* GetTexture(const UCurveFloat* RiseCurve, const UCurveFloat* FadeCurve, const FGlowCurveTable& Rise, const FGlowCurveTable& Fade);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// A null curve is a fallback function, which is the same for everyone, so it is a key as good as any curve
+	using FCurvePair = TPair<TObjectKey<UCurveFloat>, TObjectKey<UCurveFloat>>;
+
+	TMap<FCurvePair, UTexture2D*> TexturesByCurves;
+
+	// Keeps the textures of the map alive
+	UPROPERTY()
+	TArray<TObjectPtr<UTexture2D>> Textures;
+};
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowCurveTable.h"
+
+#include "Curves/CurveFloat.h"
+#include "Engine/Texture2D.h"
+
+void FGlowCurveTable::Bake(const UCurveFloat* const Curve, const TFunctionRef<float(float)> Fallback)
+{
+	for (int32 i = 0; i < NumSamples; i++)
+	{
+		const float Time = static_cast<float>(i) / (NumSamples - 1);
+		Samples[i] = Curve ? Curve->GetFloatValue(Time) : Fallback(Time);
+	}
+}
+
+float FGlowCurveTable::Evaluate(const float Time) const
+{
+	const float Position = FMath::Clamp(Time, 0.f, 1.f) * (NumSamples - 1);
+	const int32 Index = FMath::Min(static_cast<int32>(Position), NumSamples - 2);
+
+	return FMath::Lerp(Samples[Index], Samples[Index + 1], Position - Index);
+}
+
+UTexture2D* FGlowCurveTable::CreateTexture(const FGlowCurveTable& Rise, const FGlowCurveTable& Fade)
+{
+	UTexture2D* const Texture = UTexture2D::CreateTransient(NumSamples, 1, PF_G32R32F);
+	if (!Texture)
+		return nullptr;
+
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	FVector2f* const Texels = static_cast<FVector2f*>(Mip.BulkData.Lock(LOCK_READ_WRITE));
+
+	for (int32 i = 0; i < NumSamples; i++)
+		Texels[i] = FVector2f(Rise.Samples[i], Fade.Samples[i]);
+
+	Mip.BulkData.Unlock();
+
+	// Interpolated like Evaluate does on the CPU
+	Texture->Filter = TF_Bilinear;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->SRGB = false;
+	Texture->UpdateResource();
+
+	return Texture;
+}
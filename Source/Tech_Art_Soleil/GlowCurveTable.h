@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <array>
+
+#include "CoreMinimal.h"
+
+class UCurveFloat;
+class UTexture2D;
+
+/**
+ * Curve baked into a fixed number of samples, so evaluating it is a lerp between two of them
+ * Curves are authored from 0 to 1 in time and in value, the same samples are uploaded for the shader
+ */
+class FGlowCurveTable final
+{
+public:
+	static constexpr int32 NumSamples = 64;
+
+	// Samples the curve, or the fallback function if no curve is set
+	void Bake(const UCurveFloat* Curve, TFunctionRef<float(float)> Fallback);
+
+	// Value of the curve at a time between 0 and 1, clamped outside of it
+	float Evaluate(float Time) const;
+
+	// Texture holding the rise curve in red and the fade curve in green, one texel per sample
+	// Sample it at (Time * (NumSamples - 1) + 0.5) / NumSamples with bilinear filtering to match Evaluate
+	static UTexture2D* CreateTexture(const FGlowCurveTable& Rise, const FGlowCurveTable& Fade);
+
+private:
+	std::array<float, NumSamples> Samples = {};
+};
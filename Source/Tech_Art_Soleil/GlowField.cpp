@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowField.h"
+
+#include "GlowOcclusionField.h"
+#include "Tech_Art_Soleil.h"
+
+DECLARE_CYCLE_STAT(TEXT("Glow field queries"), STAT_GlowFieldQueries, STATGROUP_Bioluminescence);
+
+void FGlowField::Reset()
+{
+	Points.Reset();
+}
+
+void FGlowField::AddPoint(const FVector& Center, const float Front, const float Range, const float Weight)
+{
+	// Points that can't light anything are left out, every query loops over the others
+	if (Front <= 0.f || Range <= 0.f || Weight <= 0.f)
+		return;
+
+	Points.Add({
+		static_cast<float>(Center.X),
+		static_cast<float>(Center.Y),
+		static_cast<float>(Center.Z),
+		FMath::Square(Front),
+		1.f / Range,
+		Weight
+	});
+}
+
+float FGlowField::Sample(const FVector& Location) const
+{
+	float Intensity = 0.f;
+
+	for (const FPoint& Point : Points)
+	{
+		const float DistanceSquared = FVector3f(Location.X - Point.X, Location.Y - Point.Y, Location.Z - Point.Z).SizeSquared();
+		if (DistanceSquared > Point.FrontSquared)
+			continue;
+
+		const float Falloff = FMath::Max(1.f - FMath::Sqrt(DistanceSquared) * Point.InverseRange, 0.f);
+		Intensity = FMath::Max(Intensity, Falloff * Point.Weight);
+	}
+
+	return Intensity;
+}
+
+void FGlowField::Sample(const TConstArrayView<FVector> Locations, const TArrayView<float> OutIntensities) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GlowFieldQueries);
+
+	check(Locations.Num() == OutIntensities.Num());
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+
+	// Four locations per register, every point is compared against the four at once
+	int32 i = 0;
+	for (; i + 4 <= Locations.Num(); i += 4)
+	{
+		const VectorRegister4Float X = MakeVectorRegisterFloat(
+			static_cast<float>(Locations[i].X), static_cast<float>(Locations[i + 1].X), static_cast<float>(Locations[i + 2].X), static_cast<float>(Locations[i + 3].X));
+		const VectorRegister4Float Y = MakeVectorRegisterFloat(
+			static_cast<float>(Locations[i].Y), static_cast<float>(Locations[i + 1].Y), static_cast<float>(Locations[i + 2].Y), static_cast<float>(Locations[i + 3].Y));
+		const VectorRegister4Float Z = MakeVectorRegisterFloat(
+			static_cast<float>(Locations[i].Z), static_cast<float>(Locations[i + 1].Z), static_cast<float>(Locations[i + 2].Z), static_cast<float>(Locations[i + 3].Z));
+
+		VectorRegister4Float Intensity = Zero;
+
+		for (const FPoint& Point : Points)
+		{
+			const VectorRegister4Float DeltaX = VectorSubtract(X, VectorSetFloat1(Point.X));
+			const VectorRegister4Float DeltaY = VectorSubtract(Y, VectorSetFloat1(Point.Y));
+			const VectorRegister4Float DeltaZ = VectorSubtract(Z, VectorSetFloat1(Point.Z));
+			const VectorRegister4Float DistanceSquared = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ)));
+
+			const VectorRegister4Float Inside = VectorCompareLE(DistanceSquared, VectorSetFloat1(Point.FrontSquared));
+			const VectorRegister4Float Falloff = VectorMax(VectorSubtract(One, VectorMultiply(VectorSqrt(DistanceSquared), VectorSetFloat1(Point.InverseRange))), Zero);
+
+			Intensity = VectorMax(Intensity, VectorSelect(Inside, VectorMultiply(Falloff, VectorSetFloat1(Point.Weight)), Zero));
+		}
+
+		VectorStore(Intensity, OutIntensities.GetData() + i);
+	}
+
+	for (; i < Locations.Num(); i++)
+		OutIntensities[i] = Sample(Locations[i]);
+}
+
+float FGlowField::Sample(const FVector& Location, const FGlowOcclusionField& Occlusion) const
+{
+	// Every point lighting the location, brightest first
+	TArray<TPair<float, int32>, TInlineAllocator<16>> Candidates;
+
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		const FPoint& Point = Points[i];
+
+		const float DistanceSquared = FVector3f(Location.X - Point.X, Location.Y - Point.Y, Location.Z - Point.Z).SizeSquared();
+		if (DistanceSquared > Point.FrontSquared)
+			continue;
+
+		const float Intensity = FMath::Max(1.f - FMath::Sqrt(DistanceSquared) * Point.InverseRange, 0.f) * Point.Weight;
+		if (Intensity > 0.f)
+			Candidates.Emplace(Intensity, i);
+	}
+
+	Candidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) -> bool { return A.Key > B.Key; });
+
+	// The brightest visible point wins, so the tests stop at the first one
+	for (const TPair<float, int32>& Candidate : Candidates)
+	{
+		const FPoint& Point = Points[Candidate.Value];
+		if (!Occlusion.IsOccluded(FVector(Point.X, Point.Y, Point.Z), Location))
+			return Candidate.Key;
+	}
+
+	return 0.f;
+}
+
+void FGlowField::Sample(const TConstArrayView<FVector> Locations, const TArrayView<float> OutIntensities, const FGlowOcclusionField& Occlusion) const
+{
+	Sample(Locations, OutIntensities);
+
+	for (int32 i = 0; i < Locations.Num(); i++)
+	{
+		if (OutIntensities[i] > 0.f)
+			OutIntensities[i] = Sample(Locations[i], Occlusion);
+	}
+}
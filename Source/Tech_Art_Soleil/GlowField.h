@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FGlowOcclusionField;
+
+/**
+ * CPU approximation of the glow the material draws, so gameplay can ask how lit a location is
+ *
+ * The live points are packed once per update, then each query evaluates a simpler function than the material:
+ * a location inside the front of a point glows with the intensity of the point, lowered linearly with the distance over
+ * its range and with its fade out, and the brightest point wins
+ * The material shapes the edge of the front and the falloff with its own curves and textures, which aren't mirrored here,
+ * so a query tells where the glow is and roughly how bright, not the exact value of a pixel
+ * Batched queries evaluate four locations at once
+ */
+class FGlowField final
+{
+public:
+	void Reset();
+
+	// Front is how far the point has propagated, Range how far it can go, Weight its intensity at the centre
+	void AddPoint(const FVector& Center, float Front, float Range, float Weight);
+
+	// Glow intensity at a location, 0 where nothing glows
+	float Sample(const FVector& Location) const;
+
+	// Same as Sample for every location, OutIntensities must be as long as Locations
+	void Sample(TConstArrayView<FVector> Locations, TArrayView<float> OutIntensities) const;
+
+	// Same as Sample, except points hidden from the location by solid geometry don't light it
+	float Sample(const FVector& Location, const FGlowOcclusionField& Occlusion) const;
+
+	// Batched Sample first, only the lit locations are then tested against the occlusion
+	void Sample(TConstArrayView<FVector> Locations, TArrayView<float> OutIntensities, const FGlowOcclusionField& Occlusion) const;
+
+	int32 GetNumPoints() const { return Points.Num(); }
+
+private:
+	struct FPoint final
+	{
+		float X;
+		float Y;
+		float Z;
+		float FrontSquared;
+		float InverseRange;
+		float Weight;
+	};
+
+	TArray<FPoint> Points;
+};
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowLightPoolComponent.h"
+
+#include "Components/PointLightComponent.h"
+
+UGlowLightPoolComponent::UGlowLightPoolComponent()
+{
+	// Driven by the glow that owns it, after its points advanced
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UGlowLightPoolComponent::Update(const TConstArrayView<FSource> Sources, const float DeltaTime)
+{
+	if (Lights.Num() != PoolSize)
+		CreateLights();
+
+	BuildClusters(Sources);
+	AssignClusters();
+
+	for (int32 i = 0; i < Lights.Num(); i++)
+	{
+		FLightState& State = States[i];
+		UPointLightComponent* const Light = Lights[i];
+
+		State.Intensity = FMath::FInterpTo(State.Intensity, State.TargetIntensity, DeltaTime, FadeSpeed);
+		State.Position = FMath::VInterpTo(State.Position, State.TargetPosition, DeltaTime, FadeSpeed);
+		State.Radius = FMath::FInterpTo(State.Radius, State.TargetRadius, DeltaTime, FadeSpeed);
+
+		// A faded out light costs nothing once hidden
+		const bool bVisible = State.Intensity > KINDA_SMALL_NUMBER;
+		if (Light->IsVisible() != bVisible)
+			Light->SetVisibility(bVisible);
+
+		if (!bVisible)
+			continue;
+
+		Light->SetWorldLocation(State.Position);
+		Light->SetIntensity(State.Intensity);
+		Light->SetAttenuationRadius(State.Radius);
+	}
+}
+
+void UGlowLightPoolComponent::CreateLights()
+{
+	for (UPointLightComponent* const Light : Lights)
+		Light->DestroyComponent();
+
+	Lights.Reset(PoolSize);
+	States.Init(FLightState(), PoolSize);
+
+	for (int32 i = 0; i < PoolSize; i++)
+	{
+		UPointLightComponent* const Light = NewObject<UPointLightComponent>(GetOwner());
+		Light->SetMobility(EComponentMobility::Movable);
+		Light->SetCastShadows(false);
+		Light->SetIntensityUnits(ELightUnits::Candelas);
+		Light->SetLightColor(LightColor);
+		Light->SetVisibility(false);
+		Light->RegisterComponent();
+
+		Lights.Add(Light);
+	}
+}
+
+void UGlowLightPoolComponent::BuildClusters(const TConstArrayView<FSource> Sources)
+{
+	Clusters.Reset();
+
+	// Brightest first, so the clusters form around the points that matter most
+	SourceOrder.Reset(Sources.Num());
+	for (int32 i = 0; i < Sources.Num(); i++)
+	{
+		if (Sources[i].Weight > 0.f)
+			SourceOrder.Add(i);
+	}
+
+	SourceOrder.Sort([&Sources](const int32 A, const int32 B) -> bool { return Sources[A].Weight > Sources[B].Weight; });
+
+	for (const int32 SourceIndex : SourceOrder)
+	{
+		const FSource& Source = Sources[SourceIndex];
+
+		// Joins the closest cluster in range, or the closest one at all when the pool is full
+		int32 Closest = INDEX_NONE;
+		double ClosestDistance = TNumericLimits<double>::Max();
+
+		for (int32 i = 0; i < Clusters.Num(); i++)
+		{
+			const double Distance = FVector::DistSquared(Clusters[i].Position, Source.Position);
+			if (Distance < ClosestDistance)
+			{
+				Closest = i;
+				ClosestDistance = Distance;
+			}
+		}
+
+		if (Closest == INDEX_NONE || (ClosestDistance > FMath::Square(ClusterRadius) && Clusters.Num() < PoolSize))
+		{
+			Clusters.Add({ Source.Position, Source.Weight, Source.Radius });
+			continue;
+		}
+
+		FCluster& Cluster = Clusters[Closest];
+		const float TotalWeight = Cluster.Weight + Source.Weight;
+
+		Cluster.Position = FMath::Lerp(Cluster.Position, Source.Position, Source.Weight / TotalWeight);
+		Cluster.Radius = FMath::Max(Cluster.Radius, FVector::Dist(Cluster.Position, Source.Position) + Source.Radius);
+		Cluster.Weight = TotalWeight;
+	}
+}
+
+void UGlowLightPoolComponent::AssignClusters()
+{
+	for (FLightState& State : States)
+		State.TargetIntensity = 0.f;
+
+	TBitArray<> Taken(false, States.Num());
+
+	for (const FCluster& Cluster : Clusters)
+	{
+		// The closest lit light in reach keeps following its cluster, then an unlit one fades in,
+		// and only a saturated pool moves a light across to a far cluster
+		constexpr double UnlitScore = TNumericLimits<float>::Max();
+		constexpr double FarScore = UnlitScore * 2.;
+		const double Reach = FMath::Square(ClusterRadius * 2.);
+
+		int32 Best = INDEX_NONE;
+		double BestScore = TNumericLimits<double>::Max();
+
+		for (int32 i = 0; i < States.Num(); i++)
+		{
+			if (Taken[i])
+				continue;
+
+			double Score = UnlitScore;
+			if (States[i].Intensity > KINDA_SMALL_NUMBER)
+			{
+				const double Distance = FVector::DistSquared(States[i].Position, Cluster.Position);
+				Score = Distance <= Reach ? Distance : FarScore;
+			}
+
+			if (Score < BestScore)
+			{
+				Best = i;
+				BestScore = Score;
+			}
+		}
+
+		if (Best == INDEX_NONE)
+			break;
+
+		Taken[Best] = true;
+		FLightState& State = States[Best];
+
+		// A light starting from nothing appears where its cluster is, it doesn't slide from its last place
+		if (State.Intensity <= KINDA_SMALL_NUMBER)
+		{
+			State.Position = Cluster.Position;
+			State.Radius = Cluster.Radius * AttenuationScale;
+		}
+
+		State.TargetPosition = Cluster.Position;
+		State.TargetIntensity = MaxIntensity * FMath::Min(Cluster.Weight, 1.f);
+		State.TargetRadius = Cluster.Radius * AttenuationScale;
+	}
+}
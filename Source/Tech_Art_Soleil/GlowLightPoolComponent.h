@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GlowLightPoolComponent.generated.h"
+
+class UPointLightComponent;
+
+/**
+ * Lights the surroundings of the glow with a fixed pool of point lights
+ *
+ * The glowing points are clustered every update and each cluster drives one light of the pool,
+ * so the lighting cost depends on the size of the pool and never on the number of points
+ * Lights follow the cluster they were given last time, and fade in or out when clusters split or merge
+ */
+UCLASS(ClassGroup=(Bioluminescence), meta=(BlueprintSpawnableComponent))
+class TECH_ART_SOLEIL_API UGlowLightPoolComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	struct FSource final
+	{
+		FVector Position;
+		// How much the point glows, from 0 to 1
+		float Weight = 0.f;
+		// How far the glow of the point currently reaches
+		float Radius = 0.f;
+	};
+
+	UGlowLightPoolComponent();
+
+	// Clusters the sources and moves the lights towards them
+	void Update(TConstArrayView<FSource> Sources, float DeltaTime);
+
+	// Maximum number of lights, the lighting cost is bounded by it
+	UPROPERTY(EditAnywhere, meta = (ClampMin = 1, ClampMax = 32))
+	int32 PoolSize = 8;
+
+	// Points closer than this to a cluster are merged into it
+	UPROPERTY(EditAnywhere)
+	float ClusterRadius = 400.f;
+
+	// Intensity of a light for a fully glowing cluster, in candelas
+	UPROPERTY(EditAnywhere)
+	float MaxIntensity = 20.f;
+
+	// Attenuation radius of a light, relative to the radius of its cluster
+	UPROPERTY(EditAnywhere)
+	float AttenuationScale = 1.5f;
+
+	UPROPERTY(EditAnywhere)
+	FLinearColor LightColor = FLinearColor(0.1f, 0.6f, 1.f);
+
+	// How fast the lights reach their cluster, in intensity and in position
+	UPROPERTY(EditAnywhere)
+	float FadeSpeed = 4.f;
+
+private:
+	struct FCluster final
+	{
+		FVector Position;
+		float Weight = 0.f;
+		float Radius = 0.f;
+	};
+
+	struct FLightState final
+	{
+		FVector Position = FVector::ZeroVector;
+		float Intensity = 0.f;
+		float Radius = 0.f;
+
+		FVector TargetPosition = FVector::ZeroVector;
+		float TargetIntensity = 0.f;
+		float TargetRadius = 0.f;
+	};
+
+	void CreateLights();
+	void BuildClusters(TConstArrayView<FSource> Sources);
+	void AssignClusters();
+
+	UPROPERTY()
+	TArray<TObjectPtr<UPointLightComponent>> Lights;
+
+	TArray<FLightState> States;
+
+	// Kept between updates so the clustering doesn't allocate
+	TArray<FCluster> Clusters;
+	TArray<int32> SourceOrder;
+};
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowMushroomField.h"
+
+#include "GlowMushroomFieldComponent.h"
+#include "Tech_Art_Soleil.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+#if WITH_EDITOR
+#include "ScopedTransaction.h"
+#endif
+
+AGlowMushroomField::AGlowMushroomField()
+{
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+}
+
+#if WITH_EDITOR
+void AGlowMushroomField::ConvertPlacedActors()
+{
+	if (!SourceClass)
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("%s: no source class to convert"), *GetName());
+		return;
+	}
+
+	TArray<AActor*> Actors;
+	UGameplayStatics::GetAllActorsOfClass(GetWorld(), SourceClass, Actors);
+
+	// A single undo brings the placed actors back and empties the field again
+	const FScopedTransaction Transaction(NSLOCTEXT("GlowMushroomField", "ConvertPlacedActors", "Convert Placed Mushrooms"));
+	Modify();
+
+	int32 NumConverted = 0;
+	int32 NumSkipped = 0;
+	for (AActor* const Actor : Actors)
+	{
+		// Only the actors of the level this field is in
+		if (Actor->GetLevel() != GetLevel())
+			continue;
+
+		// An instance only stands for a single mesh, deleting the actor would lose the others
+		TArray<const UStaticMeshComponent*> Meshes;
+		Actor->GetComponents<const UStaticMeshComponent>(Meshes);
+		if (Meshes.Num() != 1 || !Meshes[0]->GetStaticMesh())
+		{
+			UE_LOG(LogBioluminescence, Warning, TEXT("%s has %d mesh components, only actors with a single mesh are converted, it is left as it is"),
+				*Actor->GetName(), Meshes.Num());
+			NumSkipped++;
+			continue;
+		}
+
+		const UStaticMeshComponent* const Source = Meshes[0];
+		UGlowMushroomFieldComponent* const Variant = FindOrAddVariant(Source->GetStaticMesh(), Source->OverrideMaterials, Source->GetCollisionProfileName());
+		Variant->Modify();
+		Variant->AddMushroom(Source->GetComponentTransform());
+
+		GetWorld()->EditorDestroyActor(Actor, true);
+		NumConverted++;
+	}
+
+	UE_LOG(LogBioluminescence, Display, TEXT("%s: converted %d actors of %s, skipped %d"), *GetName(), NumConverted, *SourceClass->GetName(), NumSkipped);
+}
+#endif
+
+UGlowMushroomFieldComponent* AGlowMushroomField::FindOrAddVariant(
+	UStaticMesh* const Mesh,
+	const TArray<TObjectPtr<UMaterialInterface>>& Materials,
+	const FName CollisionProfile
+)
+{
+	TArray<UGlowMushroomFieldComponent*> Variants;
+	GetComponents<UGlowMushroomFieldComponent>(Variants);
+
+	for (UGlowMushroomFieldComponent* const Variant : Variants)
+	{
+		if (Variant->GetStaticMesh() == Mesh && Variant->OverrideMaterials == Materials)
+			return Variant;
+	}
+
+	UGlowMushroomFieldComponent* const Variant = NewObject<UGlowMushroomFieldComponent>(this, NAME_None, RF_Transactional);
+	Variant->SetMobility(EComponentMobility::Static);
+	Variant->SetStaticMesh(Mesh);
+	Variant->OverrideMaterials = Materials;
+	Variant->SetCollisionProfileName(CollisionProfile);
+	Variant->SetupAttachment(RootComponent);
+
+	AddInstanceComponent(Variant);
+	Variant->RegisterComponent();
+
+	return Variant;
+}
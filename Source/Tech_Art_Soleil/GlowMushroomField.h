@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GlowMushroomField.generated.h"
+
+class UGlowMushroomFieldComponent;
+class UMaterialInterface;
+class UStaticMesh;
+
+/**
+ * A field of mushrooms, with one instanced component per mushroom variant
+ *
+ * Thousands of mushrooms cost a few components and material instances, the way a foliage layer does,
+ * instead of one actor, one hit delegate and one material instance each
+ */
+UCLASS()
+class TECH_ART_SOLEIL_API AGlowMushroomField : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGlowMushroomField();
+
+#if WITH_EDITORONLY_DATA
+	// Placed actors of this class are turned into instances of the field by ConvertPlacedActors
+	UPROPERTY(EditAnywhere, Category = "Conversion")
+	TSubclassOf<AActor> SourceClass;
+#endif
+
+#if WITH_EDITOR
+	// Adds every placed actor of the source class in the level to the field, then deletes them
+	UFUNCTION(CallInEditor, Category = "Conversion")
+	void ConvertPlacedActors();
+#endif
+
+private:
+	// Component drawing the mushrooms with this mesh and these materials, created the first time it is needed
+	UGlowMushroomFieldComponent* FindOrAddVariant(UStaticMesh* Mesh, const TArray<TObjectPtr<UMaterialInterface>>& Materials, FName CollisionProfile);
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowMushroomFieldComponent.h"
+
+UGlowMushroomFieldComponent::UGlowMushroomFieldComponent()
+{
+	NumCustomDataFloats = NumGlowData;
+
+	// Only ticks on frames with a hit, to send them all at once, see MarkHit
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UGlowMushroomFieldComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* const ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	MarkRenderStateDirty();
+	SetComponentTickEnabled(false);
+}
+
+int32 UGlowMushroomFieldComponent::AddMushroom(const FTransform& WorldTransform, const float GlowScale)
+{
+	const int32 Instance = AddInstance(WorldTransform, true);
+
+	// Never hit so far, far enough in the past that the flash is over
+	SetCustomDataValue(Instance, GlowScaleData, GlowScale);
+	SetCustomDataValue(Instance, LastHitTimeData, -UE_BIG_NUMBER, true);
+
+	return Instance;
+}
+
+int32 UGlowMushroomFieldComponent::FindInstance(const FVector& Location, const float Radius) const
+{
+	// The instance tree only returns the instances near the location
+	const TArray<int32> Candidates = GetInstancesOverlappingSphere(Location, Radius, true);
+
+	int32 Closest = INDEX_NONE;
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+
+	for (const int32 Candidate : Candidates)
+	{
+		FTransform Transform;
+		GetInstanceTransform(Candidate, Transform, true);
+
+		const double DistanceSquared = FVector::DistSquared(Transform.GetLocation(), Location);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			Closest = Candidate;
+			ClosestDistanceSquared = DistanceSquared;
+		}
+	}
+
+	return Closest;
+}
+
+void UGlowMushroomFieldComponent::MarkHit(const int32 Instance, const float Time)
+{
+	if (!IsValidInstance(Instance))
+		return;
+
+	// Dirtying the render state recreates the proxy, once per frame is enough however many mushrooms were hit
+	SetCustomDataValue(Instance, LastHitTimeData, Time, false);
+	SetComponentTickEnabled(true);
+}
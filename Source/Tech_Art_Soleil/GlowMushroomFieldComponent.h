@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "GlowMushroomFieldComponent.generated.h"
+
+/**
+ * Every mushroom of one variant, drawn as instances of a single mesh with a single material instance
+ *
+ * Each instance carries its own glow data in its custom data, read by the mushroom material:
+ * how strongly it glows, and when it was last hit so it can flash on its own
+ * Hits only write the custom data, the render state is sent once at the end of a frame with any hit
+ */
+UCLASS(ClassGroup=(Bioluminescence), meta=(BlueprintSpawnableComponent))
+class TECH_ART_SOLEIL_API UGlowMushroomFieldComponent : public UHierarchicalInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Custom data of each instance
+	static constexpr int32 GlowScaleData = 0;
+	static constexpr int32 LastHitTimeData = 1;
+	static constexpr int32 NumGlowData = 2;
+
+	UGlowMushroomFieldComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	int32 AddMushroom(const FTransform& WorldTransform, float GlowScale = 1.f);
+
+	// Instance closest to a location within the radius, INDEX_NONE if there is none
+	int32 FindInstance(const FVector& Location, float Radius) const;
+
+	// The flash shows from the end of the frame on, along with every other hit of the frame
+	void MarkHit(int32 Instance, float Time);
+};
@@ -0,0 +1,203 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowOcclusionField.h"
+
+#include "Tech_Art_Soleil.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Glow occlusion build"), STAT_GlowOcclusionBuild, STATGROUP_Bioluminescence);
+DECLARE_CYCLE_STAT(TEXT("Glow occlusion tests"), STAT_GlowOcclusionTests, STATGROUP_Bioluminescence);
+
+void FGlowOcclusionField::BeginBuild(const FBox& InBounds, const float InCellSize, const int32 MaxCells)
+{
+	const FVector Size = InBounds.GetSize();
+	CellSize = FMath::Max(InCellSize, 1.f);
+
+	const auto CountCells = [&Size](const float Cell) -> FIntVector
+	{
+		return FIntVector(
+			FMath::Max(FMath::CeilToInt(Size.X / Cell), 1),
+			FMath::Max(FMath::CeilToInt(Size.Y / Cell), 1),
+			FMath::Max(FMath::CeilToInt(Size.Z / Cell), 1));
+	};
+
+	// Coarser cells rather than a field too long to build
+	Dimensions = CountCells(CellSize);
+	while (static_cast<int64>(Dimensions.X) * Dimensions.Y * Dimensions.Z > MaxCells)
+	{
+		CellSize *= 1.25f;
+		Dimensions = CountCells(CellSize);
+	}
+
+	Bounds = FBox(InBounds.Min, InBounds.Min + FVector(Dimensions) * CellSize);
+	MaxDistance = CellSize * 4.f;
+	SolidDistance = CellSize * 0.25f;
+
+	Distances.SetNumUninitialized(Dimensions.X * Dimensions.Y * Dimensions.Z);
+	NextLine = 0;
+}
+
+bool FGlowOcclusionField::ContinueBuild(const UWorld& World, const double TimeBudget)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GlowOcclusionBuild);
+
+	const int32 NumLines = Dimensions.Y * Dimensions.Z;
+
+	// One line per worker at a time, the budget is checked between the batches
+	const int32 LinesPerBatch = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+	const double EndTime = FPlatformTime::Seconds() + TimeBudget;
+
+	while (NextLine < NumLines && FPlatformTime::Seconds() < EndTime)
+	{
+		const int32 FirstLine = NextLine;
+		const int32 NumBatchLines = FMath::Min(LinesPerBatch, NumLines - FirstLine);
+
+		// Scene queries can run on any thread, the game thread waits here so nothing they return is destroyed meanwhile
+		ParallelFor(NumBatchLines, [this, &World, FirstLine](const int32 i)
+		{
+			MeasureLine(World, FirstLine + i);
+		});
+
+		NextLine += NumBatchLines;
+	}
+
+	return NextLine >= NumLines;
+}
+
+void FGlowOcclusionField::MeasureLine(const UWorld& World, const int32 Line)
+{
+	// Only the static geometry occludes, luminescent objects and anything moving are left out of the field
+	const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(GlowOcclusionBuild), false);
+	const FCollisionShape Sphere = FCollisionShape::MakeSphere(MaxDistance);
+
+	const int32 Y = Line % Dimensions.Y;
+	const int32 Z = Line / Dimensions.Y;
+
+	TArray<FOverlapResult> Overlaps;
+
+	for (int32 X = 0; X < Dimensions.X; X++)
+	{
+		const FVector Center = Bounds.Min + (FVector(X, Y, Z) + 0.5) * CellSize;
+
+		Overlaps.Reset();
+		World.OverlapMultiByObjectType(Overlaps, Center, FQuat::Identity, ObjectParams, Sphere, QueryParams);
+
+		float Distance = MaxDistance;
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			const UPrimitiveComponent* const Component = Overlap.GetComponent();
+			if (!Component)
+				continue;
+
+			// Negative when the component has no simple collision to measure, it doesn't occlude then
+			FVector ClosestPoint;
+			const float ComponentDistance = Component->GetDistanceToCollision(Center, ClosestPoint);
+			if (ComponentDistance >= 0.f)
+				Distance = FMath::Min(Distance, ComponentDistance);
+		}
+
+		Distances[GetCellIndex(X, Y, Z)] = Distance;
+	}
+}
+
+float FGlowOcclusionField::SampleDistance(const FVector& Location) const
+{
+	if (!Bounds.IsInsideOrOn(Location))
+		return MaxDistance;
+
+	// Distances are measured at the cell centres, interpolated in between
+	const FVector Cell = (Location - Bounds.Min) / CellSize - 0.5;
+
+	const auto Axis = [](const double Coordinate, const int32 Dimension, int32& OutLow, int32& OutHigh) -> float
+	{
+		const double Clamped = FMath::Clamp(Coordinate, 0., Dimension - 1.);
+		OutLow = FMath::FloorToInt(Clamped);
+		OutHigh = FMath::Min(OutLow + 1, Dimension - 1);
+		return static_cast<float>(Clamped - OutLow);
+	};
+
+	int32 X0, X1, Y0, Y1, Z0, Z1;
+	const float AlphaX = Axis(Cell.X, Dimensions.X, X0, X1);
+	const float AlphaY = Axis(Cell.Y, Dimensions.Y, Y0, Y1);
+	const float AlphaZ = Axis(Cell.Z, Dimensions.Z, Z0, Z1);
+
+	const auto Line = [this, X0, X1, AlphaX](const int32 Y, const int32 Z) -> float
+	{
+		return FMath::Lerp(Distances[GetCellIndex(X0, Y, Z)], Distances[GetCellIndex(X1, Y, Z)], AlphaX);
+	};
+
+	return FMath::Lerp(
+		FMath::Lerp(Line(Y0, Z0), Line(Y1, Z0), AlphaY),
+		FMath::Lerp(Line(Y0, Z1), Line(Y1, Z1), AlphaY),
+		AlphaZ);
+}
+
+FVector FGlowOcclusionField::LiftOffSurface(const FVector& Location) const
+{
+	const float Clearance = SampleDistance(Location);
+	if (Clearance >= CellSize)
+		return Location;
+
+	// The distance grows away from the collision, its gradient is the normal of the surface nearby
+	const float Step = CellSize * 0.5f;
+	const FVector Gradient(
+		SampleDistance(Location + FVector(Step, 0., 0.)) - SampleDistance(Location - FVector(Step, 0., 0.)),
+		SampleDistance(Location + FVector(0., Step, 0.)) - SampleDistance(Location - FVector(0., Step, 0.)),
+		SampleDistance(Location + FVector(0., 0., Step)) - SampleDistance(Location - FVector(0., 0., Step)));
+
+	const FVector Normal = Gradient.GetSafeNormal();
+	if (Normal.IsZero())
+		return Location;
+
+	return Location + Normal * (CellSize - Clearance);
+}
+
+bool FGlowOcclusionField::IsOccluded(const FVector& InFrom, const FVector& InTo) const
+{
+	if (!IsBuilt())
+		return false;
+
+	// Two points on the same floor would otherwise march through the floor itself the whole way
+	const FVector From = LiftOffSurface(InFrom);
+	const FVector To = LiftOffSurface(InTo);
+
+	FVector Direction;
+	double Length;
+	(To - From).ToDirectionAndLength(Direction, Length);
+
+	// Both ends usually sit on a surface, only what lies in between can block
+	const double End = Length - CellSize;
+
+	for (double Distance = CellSize; Distance < End;)
+	{
+		const float Clearance = SampleDistance(From + Direction * Distance);
+		if (Clearance < SolidDistance)
+			return true;
+
+		// Nothing can be closer than the clearance, but the grid doesn't resolve less than half a cell either
+		Distance += FMath::Max(Clearance - SolidDistance, CellSize * 0.5f);
+	}
+
+	return false;
+}
+
+void FGlowOcclusionField::TestOcclusion(const TConstArrayView<FVector> From, const TConstArrayView<FVector> To, const TArrayView<bool> OutOccluded) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GlowOcclusionTests);
+
+	check(From.Num() == To.Num() && From.Num() == OutOccluded.Num());
+
+	// A few tests aren't worth waking the workers
+	constexpr int32 MinParallelTests = 32;
+
+	ParallelFor(From.Num(), [this, From, To, OutOccluded](const int32 i)
+	{
+		OutOccluded[i] = IsOccluded(From[i], To[i]);
+	}, From.Num() < MinParallelTests ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Coarse distance field of the static geometry, so the glow can tell whether a wall or a rock stands between two points
+ *
+ * The distance to the nearest static collision is measured once at the centre of every cell of a grid,
+ * then a test marches along the segment, skipping ahead by the distance the field guarantees to be empty
+ * A test only reads the grid, there is no physics query once the field is built
+ */
+class FGlowOcclusionField final
+{
+public:
+	// Lays out the grid over the bounds, the cells grow when the bounds would need more than MaxCells of them
+	// Nothing is measured yet, see ContinueBuild
+	void BeginBuild(const FBox& InBounds, float InCellSize, int32 MaxCells);
+
+	// Measures the distance to the static collision of the world at the centre of the next cells, for about TimeBudget seconds
+	// Must run on the game thread, the collision components it reads can't go away while it waits for the workers
+	// Returns whether every cell is measured
+	bool ContinueBuild(const UWorld& World, double TimeBudget);
+
+	bool IsBuilt() const { return !Distances.IsEmpty() && NextLine >= Dimensions.Y * Dimensions.Z; }
+
+	// Area covered by the grid, a whole number of cells
+	const FBox& GetBounds() const { return Bounds; }
+
+	float GetCellSize() const { return CellSize; }
+
+	// Distance to the nearest static collision, interpolated between the cells, as far as measured outside of the bounds
+	float SampleDistance(const FVector& Location) const;
+
+	// Whether solid geometry lies between the two points
+	// Ends close to a surface are lifted off it first, so points on the same floor or wall see each other,
+	// and one cell around both ends is ignored
+	bool IsOccluded(const FVector& From, const FVector& To) const;
+
+	// Same as IsOccluded for every pair, OutOccluded must be as long as From and To
+	void TestOcclusion(TConstArrayView<FVector> From, TConstArrayView<FVector> To, TArrayView<bool> OutOccluded) const;
+
+private:
+	int32 GetCellIndex(int32 X, int32 Y, int32 Z) const { return (Z * Dimensions.Y + Y) * Dimensions.X + X; }
+
+	// Measures every cell of a line along X
+	void MeasureLine(const UWorld& World, int32 Line);
+
+	// Moves a location close to the collision out of it along the field gradient, until it is a cell away from it
+	FVector LiftOffSurface(const FVector& Location) const;
+
+	FBox Bounds = FBox(ForceInit);
+	FIntVector Dimensions = FIntVector::ZeroValue;
+	float CellSize = 0.f;
+
+	// Distances are only measured up to this, further ones are clamped
+	float MaxDistance = 0.f;
+
+	// Locations closer than this to the collision count as inside it, the grid can't resolve anything thinner
+	float SolidDistance = 0.f;
+
+	// One distance per cell, X first
+	TArray<float> Distances;
+
+	// Next line along X to measure, lines are indexed Y first
+	int32 NextLine = 0;
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowOcclusionSubsystem.h"
+
+#include "Tech_Art_Soleil.h"
+
+void UGlowOcclusionSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Bounds included during a build wait for it, a single field builds at a time
+	if (bBuildPending && !BuildingField)
+	{
+		bBuildPending = false;
+
+		BuildingField = MakeUnique<FGlowOcclusionField>();
+		BuildingField->BeginBuild(Bounds, CellSize, MaxCells);
+		BuildStartTime = FPlatformTime::Seconds();
+	}
+
+	if (!BuildingField || !BuildingField->ContinueBuild(*GetWorld(), BuildBudgetMs * 0.001))
+		return;
+
+	Field = MoveTemp(BuildingField);
+
+	UE_LOG(LogBioluminescence, Log, TEXT("Built the glow occlusion field over %s with %.0f cm cells in %.2f s"),
+		*Field->GetBounds().GetSize().ToString(), Field->GetCellSize(), FPlatformTime::Seconds() - BuildStartTime);
+}
+
+TStatId UGlowOcclusionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGlowOcclusionSubsystem, STATGROUP_Tickables);
+}
+
+void UGlowOcclusionSubsystem::IncludeBounds(const FBox& InBounds)
+{
+	if (!bEnabled || !InBounds.IsValid)
+		return;
+
+	// Either built already or about to be, only a rebuild can grow the field, which isn't worth it for bounds it covers
+	if (Bounds.IsValid && Bounds.IsInside(InBounds))
+		return;
+
+	Bounds += InBounds.ExpandBy(BoundsPadding);
+	bBuildPending = true;
+}
+
+bool UGlowOcclusionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlowOcclusionField.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GlowOcclusionSubsystem.generated.h"
+
+/**
+ * Builds the occlusion field over the area the glow can reach, so chains and glow queries stop at solid geometry
+ *
+ * Luminescent objects and glow participants add their bounds as they begin play, padded so whatever shows up later
+ * nearby is already covered
+ * The field is built a slice at a time on the game thread once they are all known, and again only if something outside
+ * of it shows up, queries keep using the previous field until the new one replaces it
+ */
+UCLASS(config=Game)
+class TECH_ART_SOLEIL_API UGlowOcclusionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Makes the field cover these bounds, once the build it triggers completes
+	void IncludeBounds(const FBox& InBounds);
+
+	// Null until the first build completes, nothing is occluded until then
+	const FGlowOcclusionField* GetField() const { return Field.Get(); }
+
+	// Size of a cell of the field, walls thinner than a quarter of it can be missed
+	UPROPERTY(config)
+	float CellSize = 50.f;
+
+	// Upper bound on the number of cells, the cells grow when the bounds need more
+	UPROPERTY(config)
+	int32 MaxCells = 128 * 128 * 16;
+
+	// Added around every bounds included, so objects spawned close to the others don't need a rebuild
+	UPROPERTY(config)
+	float BoundsPadding = 2000.f;
+
+	// Game thread time a build takes per frame, in milliseconds, the workers measure the cells meanwhile
+	UPROPERTY(config)
+	float BuildBudgetMs = 2.f;
+
+	// Chains and glow queries go through solid geometry when disabled
+	UPROPERTY(config)
+	bool bEnabled = true;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// The field queries read
+	TUniquePtr<FGlowOcclusionField> Field;
+
+	// Field being built over the next frames, nothing reads it before it is complete
+	TUniquePtr<FGlowOcclusionField> BuildingField;
+	double BuildStartTime = 0.;
+
+	// Everything the field has to cover, padded, including what the current build doesn't cover yet
+	FBox Bounds = FBox(ForceInit);
+
+	bool bBuildPending = false;
+};
@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowPointAtlas.h"
+
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "TextureResource.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Misc/CoreDelegates.h"
+
+namespace
+{
+	FFloat16Color ToHalfTexel(const FVector4f& Texel)
+	{
+		return FFloat16Color(FLinearColor(Texel.X, Texel.Y, Texel.Z, Texel.W));
+	}
+}
+
+TSharedRef<FGlowPointAtlas, ESPMode::ThreadSafe> FGlowPointAtlas::Create(
+	const UTextureRenderTarget2D* const PointsTexture,
+	const UTextureRenderTarget2D* const TimesTexture,
+	const int32 NumPoints,
+	const int32 NumRows,
+	const bool bHalfPrecisionTimes
+)
+{
+	TSharedRef<FGlowPointAtlas, ESPMode::ThreadSafe> Atlas = MakeShareable(new FGlowPointAtlas(PointsTexture, TimesTexture, NumPoints, NumRows, bHalfPrecisionTimes));
+
+	// Same as the point buffers, the begin frame delegate has to be bound from the render thread
+	ENQUEUE_RENDER_COMMAND(RegisterGlowPointAtlas)([Atlas](FRHICommandListImmediate&)
+	{
+		Atlas->BeginFrameHandle = FCoreDelegates::OnBeginFrameRT.AddThreadSafeSP(Atlas, &FGlowPointAtlas::Upload_RenderThread);
+	});
+
+	return Atlas;
+}
+
+FGlowPointAtlas::FGlowPointAtlas(
+	const UTextureRenderTarget2D* const PointsTexture,
+	const UTextureRenderTarget2D* const TimesTexture,
+	const int32 InNumPoints,
+	const int32 InNumRows,
+	const bool bInHalfPrecisionTimes
+)
+	: NumPoints(InNumPoints)
+	, NumRows(InNumRows)
+	, bHalfPrecisionTimes(bInHalfPrecisionTimes)
+	, PointsResource(PointsTexture ? PointsTexture->GetResource() : nullptr)
+	, TimesResource(TimesTexture ? TimesTexture->GetResource() : nullptr)
+{
+	// The textures start cleared to the empty texel, the copy starts the same
+	Points.Init(FGlowPointBuffer::EmptyTexel, NumPoints * NumRows);
+
+	if (bHalfPrecisionTimes)
+		HalfTimes.Init(ToHalfTexel(FGlowPointBuffer::EmptyTexel), NumPoints * NumRows);
+	else
+		Times.Init(FGlowPointBuffer::EmptyTexel, NumPoints * NumRows);
+}
+
+void FGlowPointAtlas::AddRow(const int32 Row, const TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe>& Buffer)
+{
+	check(Row >= 0 && Row < NumRows && Buffer->GetNumPoints() == NumPoints);
+
+	ENQUEUE_RENDER_COMMAND(AddGlowPointAtlasRow)([Atlas = AsShared(), Row, Buffer](FRHICommandListImmediate&)
+	{
+		Atlas->Rows.Add({ Row, Buffer });
+	});
+}
+
+void FGlowPointAtlas::RemoveRow(const int32 Row)
+{
+	ENQUEUE_RENDER_COMMAND(RemoveGlowPointAtlasRow)([Atlas = AsShared(), Row](FRHICommandListImmediate&)
+	{
+		Atlas->Rows.RemoveAllSwap([Row](const FRow& Other) -> bool { return Other.Index == Row; });
+
+		const int32 FirstTexel = Row * Atlas->NumPoints;
+		for (int32 i = FirstTexel; i < FirstTexel + Atlas->NumPoints; i++)
+		{
+			Atlas->Points[i] = FGlowPointBuffer::EmptyTexel;
+
+			if (Atlas->bHalfPrecisionTimes)
+				Atlas->HalfTimes[i] = ToHalfTexel(FGlowPointBuffer::EmptyTexel);
+			else
+				Atlas->Times[i] = FGlowPointBuffer::EmptyTexel;
+		}
+
+		Atlas->MarkRowDirty(Row);
+	});
+}
+
+void FGlowPointAtlas::Release()
+{
+	ENQUEUE_RENDER_COMMAND(ReleaseGlowPointAtlas)([Atlas = AsShared()](FRHICommandListImmediate&)
+	{
+		FCoreDelegates::OnBeginFrameRT.Remove(Atlas->BeginFrameHandle);
+		Atlas->Rows.Empty();
+	});
+}
+
+void FGlowPointAtlas::MarkRowDirty(const int32 Row)
+{
+	FirstDirtyRow = FMath::Min(FirstDirtyRow, Row);
+	LastDirtyRow = FMath::Max(LastDirtyRow, Row);
+}
+
+void FGlowPointAtlas::Upload_RenderThread()
+{
+	check(IsInRenderingThread());
+
+	for (const FRow& Row : Rows)
+	{
+		const FGlowPointBuffer::FSnapshot* const Snapshot = Row.Buffer->Acquire_RenderThread();
+		if (!Snapshot)
+			continue;
+
+		const int32 FirstTexel = Row.Index * NumPoints;
+		FMemory::Memcpy(&Points[FirstTexel], Snapshot->Points.GetData(), NumPoints * sizeof(FVector4f));
+
+		if (bHalfPrecisionTimes)
+		{
+			for (int32 i = 0; i < NumPoints; i++)
+				HalfTimes[FirstTexel + i] = ToHalfTexel(Snapshot->Times[i]);
+		}
+		else
+		{
+			FMemory::Memcpy(&Times[FirstTexel], Snapshot->Times.GetData(), NumPoints * sizeof(FVector4f));
+		}
+
+		MarkRowDirty(Row.Index);
+	}
+
+	if (FirstDirtyRow > LastDirtyRow)
+	{
+		// No owner published anything since the last upload
+		return;
+	}
+
+	// A single region covering every changed row, the unchanged rows in between are uploaded with their current content
+	FRHICommandListImmediate& RHICmdList = FRHICommandListImmediate::Get();
+	const FUpdateTextureRegion2D Region(0, FirstDirtyRow, 0, 0, NumPoints, LastDirtyRow - FirstDirtyRow + 1);
+	const int32 FirstTexel = FirstDirtyRow * NumPoints;
+
+	FirstDirtyRow = MAX_int32;
+	LastDirtyRow = INDEX_NONE;
+
+	if (PointsResource && PointsResource->GetTexture2DRHI())
+		RHICmdList.UpdateTexture2D(PointsResource->GetTexture2DRHI(), 0, Region, NumPoints * sizeof(FVector4f), reinterpret_cast<const uint8*>(&Points[FirstTexel]));
+
+	if (!TimesResource || !TimesResource->GetTexture2DRHI())
+		return;
+
+	if (bHalfPrecisionTimes)
+		RHICmdList.UpdateTexture2D(TimesResource->GetTexture2DRHI(), 0, Region, NumPoints * sizeof(FFloat16Color), reinterpret_cast<const uint8*>(&HalfTimes[FirstTexel]));
+	else
+		RHICmdList.UpdateTexture2D(TimesResource->GetTexture2DRHI(), 0, Region, NumPoints * sizeof(FVector4f), reinterpret_cast<const uint8*>(&Times[FirstTexel]));
+}
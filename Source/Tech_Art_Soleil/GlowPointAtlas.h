@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlowPointBuffer.h"
+#include "Math/Float16Color.h"
+
+class FTextureResource;
+class UTextureRenderTarget2D;
+
+/**
+ * Uploads the point buffers of many owners to a single pair of textures, one row per owner
+ *
+ * The render thread keeps a copy of the whole atlas, every snapshot published since the last frame is copied
+ * into its row, then the span of rows that changed is uploaded at once, whatever the number of owners
+ */
+class FGlowPointAtlas final : public TSharedFromThis<FGlowPointAtlas, ESPMode::ThreadSafe>
+{
+public:
+	// Creates the atlas and registers its upload on the render thread
+	// The textures are NumPoints wide and NumRows high, half precision times must match a RTF_RGBA16f times texture
+	static TSharedRef<FGlowPointAtlas, ESPMode::ThreadSafe> Create(const UTextureRenderTarget2D* PointsTexture, const UTextureRenderTarget2D* TimesTexture, int32 NumPoints, int32 NumRows, bool bHalfPrecisionTimes = false);
+
+	// Uploads the snapshots published on the buffer to the row from the next frame on
+	void AddRow(int32 Row, const TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe>& Buffer);
+
+	// Stops uploading to the row and clears it, so the next owner starts from empty points
+	void RemoveRow(int32 Row);
+
+	// Unregisters the upload from the render thread, the atlas is freed once the render thread is done with it
+	void Release();
+
+private:
+	FGlowPointAtlas(const UTextureRenderTarget2D* PointsTexture, const UTextureRenderTarget2D* TimesTexture, int32 InNumPoints, int32 InNumRows, bool bInHalfPrecisionTimes);
+
+	void MarkRowDirty(int32 Row);
+	void Upload_RenderThread();
+
+	struct FRow final
+	{
+		int32 Index = INDEX_NONE;
+		TSharedPtr<FGlowPointBuffer, ESPMode::ThreadSafe> Buffer;
+	};
+
+	const int32 NumPoints;
+	const int32 NumRows;
+	const bool bHalfPrecisionTimes;
+
+	// Everything below is owned by the render thread
+
+	TArray<FRow> Rows;
+
+	// Content of the whole textures, NumPoints texels per row
+	TArray<FVector4f> Points;
+	TArray<FVector4f> Times;
+	TArray<FFloat16Color> HalfTimes;
+
+	// Span of rows to upload at the next frame, empty when the first is after the last
+	int32 FirstDirtyRow = MAX_int32;
+	int32 LastDirtyRow = INDEX_NONE;
+
+	FTextureResource* PointsResource = nullptr;
+	FTextureResource* TimesResource = nullptr;
+
+	FDelegateHandle BeginFrameHandle;
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowPointAtlasSubsystem.h"
+
+#include "GlowScalability.h"
+#include "LuminescentObject.h"
+#include "Tech_Art_Soleil.h"
+#include "Kismet/KismetRenderingLibrary.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Point atlas rows"), STAT_PointAtlasRows, STATGROUP_Bioluminescence);
+
+void UGlowPointAtlasSubsystem::Deinitialize()
+{
+	if (Atlas)
+		Atlas->Release();
+
+	Atlas.Reset();
+
+	Super::Deinitialize();
+}
+
+int32 UGlowPointAtlasSubsystem::AllocateRow(const TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe>& Buffer)
+{
+	if (!Atlas)
+		CreateAtlas();
+
+	int32 Row = INDEX_NONE;
+	if (!FreeRows.IsEmpty())
+		Row = FreeRows.Pop(EAllowShrinking::No);
+	else if (NumAllocatedRows < MaxRows)
+		Row = NumAllocatedRows++;
+
+	if (Row == INDEX_NONE)
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("The point atlas is full (%d rows), raise MaxRows to fit every luminescent object"), MaxRows);
+		return INDEX_NONE;
+	}
+
+	Atlas->AddRow(Row, Buffer);
+	INC_DWORD_STAT(STAT_PointAtlasRows);
+
+	return Row;
+}
+
+void UGlowPointAtlasSubsystem::ReleaseRow(const int32 Row)
+{
+	if (!Atlas || Row == INDEX_NONE)
+		return;
+
+	Atlas->RemoveRow(Row);
+	FreeRows.Add(Row);
+	DEC_DWORD_STAT(STAT_PointAtlasRows);
+}
+
+bool UGlowPointAtlasSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGlowPointAtlasSubsystem::CreateAtlas()
+{
+	// Same layout as the textures an object used to own, stacked one object per row
+	constexpr int32 NumPoints = ALuminescentObject::MaxNumberPropagationPoints;
+	const bool bHalfPrecisionTimes = GlowScalability::UseHalfPrecisionTimes();
+
+	PointsTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, NumPoints, MaxRows, RTF_RGBA32f);
+	TimesTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, NumPoints, MaxRows, bHalfPrecisionTimes ? RTF_RGBA16f : RTF_RGBA32f);
+
+	Atlas = FGlowPointAtlas::Create(PointsTexture, TimesTexture, NumPoints, MaxRows, bHalfPrecisionTimes);
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlowPointAtlas.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GlowPointAtlasSubsystem.generated.h"
+
+class UTextureRenderTarget2D;
+
+/**
+ * Owns the point textures shared by every luminescent object of the world
+ *
+ * Each object gets a row of the atlas instead of textures of its own, its material reads the row given by the AtlasRow
+ * parameter, and all the rows published during a frame are uploaded together by the render thread
+ */
+UCLASS(config=Game)
+class TECH_ART_SOLEIL_API UGlowPointAtlasSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Row the buffer is uploaded to from now on, INDEX_NONE once the atlas is full
+	int32 AllocateRow(const TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe>& Buffer);
+
+	// Gives the row back, it is cleared before anyone else gets it
+	void ReleaseRow(int32 Row);
+
+	UTextureRenderTarget2D* GetPointsTexture() const { return PointsTexture; }
+	UTextureRenderTarget2D* GetTimesTexture() const { return TimesTexture; }
+
+	// Number of rows of the textures
+	int32 GetNumRows() const { return MaxRows; }
+
+	// How many objects can share the atlas, those beyond fall back to textures of their own
+	UPROPERTY(config)
+	int32 MaxRows = 1024;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// The textures are only created once an object needs them, with the precision of the scalability at that time
+	void CreateAtlas();
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> PointsTexture = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UTextureRenderTarget2D> TimesTexture = nullptr;
+
+	TSharedPtr<FGlowPointAtlas, ESPMode::ThreadSafe> Atlas;
+
+	// Rows given back, reused before any new one
+	TArray<int32> FreeRows;
+
+	// Rows ever handed out, the next new row
+	int32 NumAllocatedRows = 0;
+};
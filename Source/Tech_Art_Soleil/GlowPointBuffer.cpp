@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowPointBuffer.h"
+
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "TextureResource.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Misc/CoreDelegates.h"
+
+const FVector4f FGlowPointBuffer::EmptyTexel = FVector4f(0.f, 0.f, 0.f, 1.f);
+
+TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe> FGlowPointBuffer::Create(
+	const UTextureRenderTarget2D* const PointsTexture,
+	const UTextureRenderTarget2D* const TimesTexture,
+	const int32 NumPoints,
+	const bool bHalfPrecisionTimes
+)
+{
+	TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe> Buffer = MakeShareable(new FGlowPointBuffer(PointsTexture, TimesTexture, NumPoints, bHalfPrecisionTimes));
+
+	// The begin frame delegate is broadcast on the render thread, so it has to be bound from there
+	ENQUEUE_RENDER_COMMAND(RegisterGlowPointBuffer)([Buffer](FRHICommandListImmediate&)
+	{
+		Buffer->BeginFrameHandle = FCoreDelegates::OnBeginFrameRT.AddThreadSafeSP(Buffer, &FGlowPointBuffer::Upload_RenderThread);
+	});
+
+	return Buffer;
+}
+
+TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe> FGlowPointBuffer::CreateUnbound(const int32 NumPoints)
+{
+	return MakeShareable(new FGlowPointBuffer(nullptr, nullptr, NumPoints, false));
+}
+
+FGlowPointBuffer::FGlowPointBuffer(
+	const UTextureRenderTarget2D* const PointsTexture,
+	const UTextureRenderTarget2D* const TimesTexture,
+	const int32 InNumPoints,
+	const bool bInHalfPrecisionTimes
+)
+	: NumPoints(InNumPoints)
+	, bHalfPrecisionTimes(bInHalfPrecisionTimes)
+	, PointsResource(PointsTexture ? PointsTexture->GetResource() : nullptr)
+	, TimesResource(TimesTexture ? TimesTexture->GetResource() : nullptr)
+{
+	// Everything is allocated once, publishing never allocates
+	for (FSnapshot& Snapshot : Snapshots)
+	{
+		Snapshot.Points.Init(EmptyTexel, NumPoints);
+		Snapshot.Times.Init(EmptyTexel, NumPoints);
+	}
+
+	if (bHalfPrecisionTimes)
+		HalfTimes.SetNumZeroed(NumPoints);
+}
+
+void FGlowPointBuffer::Publish()
+{
+	// Hand the written snapshot over and take back whichever one was shared
+	WriteIndex = SharedIndex.exchange(WriteIndex | DirtyFlag, std::memory_order_acq_rel) & ~DirtyFlag;
+}
+
+void FGlowPointBuffer::Release()
+{
+	ENQUEUE_RENDER_COMMAND(ReleaseGlowPointBuffer)([Buffer = AsShared()](FRHICommandListImmediate&)
+	{
+		FCoreDelegates::OnBeginFrameRT.Remove(Buffer->BeginFrameHandle);
+	});
+}
+
+const FGlowPointBuffer::FSnapshot* FGlowPointBuffer::Acquire_RenderThread()
+{
+	check(IsInRenderingThread());
+
+	if ((SharedIndex.load(std::memory_order_acquire) & DirtyFlag) == 0)
+	{
+		// Nothing new since the last acquisition
+		return nullptr;
+	}
+
+	ReadIndex = SharedIndex.exchange(ReadIndex, std::memory_order_acq_rel) & ~DirtyFlag;
+	return &Snapshots[ReadIndex];
+}
+
+void FGlowPointBuffer::Upload_RenderThread()
+{
+	const FSnapshot* const NewSnapshot = Acquire_RenderThread();
+	if (!NewSnapshot)
+		return;
+
+	const FSnapshot& Snapshot = *NewSnapshot;
+
+	FRHICommandListImmediate& RHICmdList = FRHICommandListImmediate::Get();
+	const FUpdateTextureRegion2D Region(0, 0, 0, 0, NumPoints, 1);
+	const uint32 Pitch = NumPoints * sizeof(FVector4f);
+
+	if (PointsResource && PointsResource->GetTexture2DRHI())
+		RHICmdList.UpdateTexture2D(PointsResource->GetTexture2DRHI(), 0, Region, Pitch, reinterpret_cast<const uint8*>(Snapshot.Points.GetData()));
+
+	if (!TimesResource || !TimesResource->GetTexture2DRHI())
+		return;
+
+	if (bHalfPrecisionTimes)
+	{
+		for (int32 i = 0; i < NumPoints; i++)
+		{
+			const FVector4f& Times = Snapshot.Times[i];
+			HalfTimes[i] = FFloat16Color(FLinearColor(Times.X, Times.Y, Times.Z, Times.W));
+		}
+
+		RHICmdList.UpdateTexture2D(TimesResource->GetTexture2DRHI(), 0, Region, NumPoints * sizeof(FFloat16Color), reinterpret_cast<const uint8*>(HalfTimes.GetData()));
+	}
+	else
+	{
+		RHICmdList.UpdateTexture2D(TimesResource->GetTexture2DRHI(), 0, Region, Pitch, reinterpret_cast<const uint8*>(Snapshot.Times.GetData()));
+	}
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "CoreMinimal.h"
+#include "Math/Float16Color.h"
+
+class FTextureResource;
+class UTextureRenderTarget2D;
+
+/**
+ * Hands the propagation points from the game thread to the render thread without any synchronisation
+ *
+ * The game thread fills a fixed-size snapshot and publishes it into a lock-free triple buffer,
+ * the render thread picks the latest published snapshot once per frame and uploads it to the point textures
+ */
+class FGlowPointBuffer final : public TSharedFromThis<FGlowPointBuffer, ESPMode::ThreadSafe>
+{
+public:
+	struct FSnapshot final
+	{
+		// One texel per point, matches the PointsArray texture
+		TArray<FVector4f> Points;
+
+		// One texel per point, matches the TimesArray texture
+		TArray<FVector4f> Times;
+	};
+
+	// Value of an unused slot, the render target clear colour the materials were authored against
+	static const FVector4f EmptyTexel;
+
+	// Creates the buffer and registers its upload on the render thread
+	// Half precision times must match a RTF_RGBA16f times texture
+	static TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe> Create(const UTextureRenderTarget2D* PointsTexture, const UTextureRenderTarget2D* TimesTexture, int32 NumPoints, bool bHalfPrecisionTimes = false);
+
+	// Creates a buffer without any texture, its snapshots are uploaded by whoever acquires them, see FGlowPointAtlas
+	static TSharedRef<FGlowPointBuffer, ESPMode::ThreadSafe> CreateUnbound(int32 NumPoints);
+
+	// Snapshot the game thread can write to, only valid until the next Publish
+	FSnapshot& GetWriteSnapshot() { return Snapshots[WriteIndex]; }
+
+	// Makes the written snapshot the latest one, the render thread will upload it at the start of its next frame
+	void Publish();
+
+	// Unregisters the upload from the render thread, the buffer is freed once the render thread is done with it
+	void Release();
+
+	// Latest published snapshot if it hasn't been acquired yet, null otherwise
+	// Only valid until the next call, on the render thread
+	const FSnapshot* Acquire_RenderThread();
+
+	int32 GetNumPoints() const { return NumPoints; }
+
+private:
+	FGlowPointBuffer(const UTextureRenderTarget2D* PointsTexture, const UTextureRenderTarget2D* TimesTexture, int32 InNumPoints, bool bInHalfPrecisionTimes);
+
+	void Upload_RenderThread();
+
+	// Set on the shared index when the snapshot it points to hasn't been uploaded yet
+	static constexpr uint32 DirtyFlag = 1u << 31;
+
+	std::array<FSnapshot, 3> Snapshots;
+
+	// Owned by the game thread
+	uint32 WriteIndex = 0;
+
+	// Swapped by both threads, latest published snapshot
+	std::atomic<uint32> SharedIndex = 1;
+
+	// Owned by the render thread
+	uint32 ReadIndex = 2;
+
+	const int32 NumPoints;
+
+	const bool bHalfPrecisionTimes;
+
+	// Owned by the render thread, times converted to half floats before the upload
+	TArray<FFloat16Color> HalfTimes;
+
+	// Only dereferenced on the render thread
+	FTextureResource* PointsResource = nullptr;
+	FTextureResource* TimesResource = nullptr;
+
+	FDelegateHandle BeginFrameHandle;
+};
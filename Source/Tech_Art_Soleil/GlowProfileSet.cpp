@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowProfileSet.h"
+
+#include "Tech_Art_Soleil.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/HitResult.h"
+#include "Engine/Texture2D.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+void UGlowProfileSet::PostLoad()
+{
+	Super::PostLoad();
+
+	Resolve();
+}
+
+#if WITH_EDITOR
+void UGlowProfileSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Glows started afterwards pick up the edited profiles
+	Resolve();
+	Texture = nullptr;
+}
+#endif
+
+uint8 UGlowProfileSet::FindProfileIndex(const UPhysicalMaterial* const PhysicalMaterial) const
+{
+	const uint8* const Index = ProfileIndices.Find(PhysicalMaterial);
+	return Index ? *Index : 0;
+}
+
+const FGlowPropagationProfile& UGlowProfileSet::GetProfile(const uint8 Index) const
+{
+	check(Index > 0 && Index <= ResolvedProfiles.Num());
+	return ResolvedProfiles[Index - 1];
+}
+
+UTexture2D* UGlowProfileSet::GetTexture()
+{
+	if (Texture)
+		return Texture;
+
+	if (ResolvedProfiles.Num() != FMath::Min(Profiles.Num(), MaxProfiles))
+		Resolve();
+
+	// A texture can't be empty, an unused column stands in when the set has no profile
+	const int32 Width = FMath::Max(ResolvedProfiles.Num(), 1);
+
+	Texture = UTexture2D::CreateTransient(Width, 2, PF_A32B32G32R32F);
+	if (!Texture)
+		return nullptr;
+
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	FLinearColor* const Texels = static_cast<FLinearColor*>(Mip.BulkData.Lock(LOCK_READ_WRITE));
+	FMemory::Memzero(Texels, Width * 2 * sizeof(FLinearColor));
+
+	for (int32 i = 0; i < ResolvedProfiles.Num(); i++)
+	{
+		const FGlowPropagationProfile& Profile = ResolvedProfiles[i];
+		Texels[i] = FLinearColor(Profile.PropagationSpeed, Profile.PropagationDistance, Profile.IntensityRatio, Profile.FadeOutDuration);
+		Texels[Width + i] = FLinearColor(Profile.FadeOutDelay, 0.f, 0.f, 0.f);
+	}
+
+	Mip.BulkData.Unlock();
+
+	// Profiles are looked up by index, never blended
+	Texture->Filter = TF_Nearest;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->SRGB = false;
+	Texture->UpdateResource();
+
+	return Texture;
+}
+
+const UPhysicalMaterial* UGlowProfileSet::ResolvePhysicalMaterial(const UPrimitiveComponent* const Component, const FHitResult* const Hit)
+{
+	if (Hit && Hit->PhysMaterial.IsValid())
+		return Hit->PhysMaterial.Get();
+
+	if (!Component)
+		return nullptr;
+
+	const FBodyInstance* const BodyInstance = Component->GetBodyInstance();
+	return BodyInstance ? BodyInstance->GetSimplePhysicalMaterial() : nullptr;
+}
+
+void UGlowProfileSet::Resolve()
+{
+	ResolvedProfiles.Reset();
+	ProfileIndices.Reset();
+
+	for (const TPair<TObjectPtr<UPhysicalMaterial>, FGlowPropagationProfile>& Pair : Profiles)
+	{
+		if (ResolvedProfiles.Num() == MaxProfiles)
+		{
+			UE_LOG(LogBioluminescence, Warning, TEXT("%s has more than %d profiles, the extra ones are ignored"), *GetName(), MaxProfiles);
+			break;
+		}
+
+		ResolvedProfiles.Add(Pair.Value);
+		ProfileIndices.Add(Pair.Key, ResolvedProfiles.Num());
+	}
+}
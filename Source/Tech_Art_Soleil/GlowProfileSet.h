@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GlowProfileSet.generated.h"
+
+class UPhysicalMaterial;
+class UTexture2D;
+
+/**
+ * How a propagation behaves on a given surface
+ */
+USTRUCT(BlueprintType)
+struct TECH_ART_SOLEIL_API FGlowPropagationProfile
+{
+	GENERATED_BODY()
+
+	FGlowPropagationProfile() = default;
+
+	FGlowPropagationProfile(const float InPropagationDistance, const float InPropagationSpeed, const float InIntensityRatio, const float InFadeOutDelay, const float InFadeOutDuration)
+		: PropagationDistance(InPropagationDistance)
+		, PropagationSpeed(InPropagationSpeed)
+		, IntensityRatio(InIntensityRatio)
+		, FadeOutDelay(InFadeOutDelay)
+		, FadeOutDuration(InFadeOutDuration)
+	{
+	}
+
+	// How far the bioluminescence will propagate
+	UPROPERTY(EditAnywhere)
+	float PropagationDistance = 600.f;
+
+	// The speed at which the bioluminescence propagates
+	UPROPERTY(EditAnywhere)
+	float PropagationSpeed = 150.f;
+
+	// The intensity ratio of the light
+	UPROPERTY(EditAnywhere)
+	float IntensityRatio = 1.f;
+
+	// Delay before the fade out, in seconds
+	UPROPERTY(EditAnywhere)
+	float FadeOutDelay = 0.f;
+
+	// Duration of the fade out after the propagation, in seconds
+	UPROPERTY(EditAnywhere)
+	float FadeOutDuration = 1.f;
+
+	// The total time needed to finish the propagation, based on the distance and speed
+	float GetTotalPropagationTime() const { return PropagationDistance / PropagationSpeed; }
+};
+
+/**
+ * Propagation profiles keyed by physical material, shared by every glow using the set
+ *
+ * Profile indices start at 1, 0 always means the own values of the actor the propagation runs on
+ * The shader reads the profiles from a single texture built once per set, with one column per profile:
+ * the first row holds the speed, distance, intensity and fade out duration, the second the fade out delay
+ */
+UCLASS(BlueprintType)
+class TECH_ART_SOLEIL_API UGlowProfileSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Indices are replicated on a few bits, so a set can't hold more profiles than this
+	static constexpr int32 MaxProfiles = 31;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// Index of the profile of a surface, 0 when the set has none for it
+	uint8 FindProfileIndex(const UPhysicalMaterial* PhysicalMaterial) const;
+
+	// Profile at an index returned by FindProfileIndex, which can't be 0
+	const FGlowPropagationProfile& GetProfile(uint8 Index) const;
+
+	// Texture of every profile of the set, built on first use
+	UTexture2D* GetTexture();
+
+	// Physical material of a hit, or of the component when the hit didn't report any
+	static const UPhysicalMaterial* ResolvePhysicalMaterial(const UPrimitiveComponent* Component, const FHitResult* Hit = nullptr);
+
+	UPROPERTY(EditAnywhere, meta = (ForceInlineRow))
+	TMap<TObjectPtr<UPhysicalMaterial>, FGlowPropagationProfile> Profiles;
+
+private:
+	// Flattens the map, so looking a profile up is an index
+	void Resolve();
+
+	TArray<FGlowPropagationProfile> ResolvedProfiles;
+	TMap<const UPhysicalMaterial*, uint8> ProfileIndices;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UTexture2D> Texture = nullptr;
+};
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowScalability.h"
+
+#include "RHIGlobals.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarMaxManagerPoints(
+		TEXT("r.Bioluminescence.MaxManagerPoints"),
+		75,
+		TEXT("Maximum number of propagation points alive at once in the bioluminescent manager."),
+		ECVF_Scalability);
+
+	TAutoConsoleVariable<int32> CVarMaxObjectPoints(
+		TEXT("r.Bioluminescence.MaxObjectPoints"),
+		10,
+		TEXT("Maximum number of propagation points alive at once in each luminescent object."),
+		ECVF_Scalability);
+
+	TAutoConsoleVariable<float> CVarUpdateRate(
+		TEXT("r.Bioluminescence.UpdateRate"),
+		0.f,
+		TEXT("How many times per second the glow is updated, 0 to update it every frame."),
+		ECVF_Scalability);
+
+	TAutoConsoleVariable<int32> CVarHalfPrecision(
+		TEXT("r.Bioluminescence.HalfPrecision"),
+		0,
+		TEXT("1 to store the propagation times in half floats, only read when the glow is set up."),
+		ECVF_Scalability);
+
+	TAutoConsoleVariable<int32> CVarMaxChainDepth(
+		TEXT("r.Bioluminescence.MaxChainDepth"),
+		1,
+		TEXT("How many luminescent objects a hit can chain through, 0 to only light the object that was hit."),
+		ECVF_Scalability);
+}
+
+int32 GlowScalability::GetMaxManagerPoints(const int32 Capacity)
+{
+	return FMath::Clamp(CVarMaxManagerPoints.GetValueOnGameThread(), 0, Capacity);
+}
+
+int32 GlowScalability::GetMaxObjectPoints(const int32 Capacity)
+{
+	return FMath::Clamp(CVarMaxObjectPoints.GetValueOnGameThread(), 0, Capacity);
+}
+
+float GlowScalability::GetUpdateInterval()
+{
+	const float UpdateRate = CVarUpdateRate.GetValueOnGameThread();
+	return UpdateRate > 0.f ? 1.f / UpdateRate : 0.f;
+}
+
+bool GlowScalability::UseHalfPrecisionTimes()
+{
+	return CVarHalfPrecision.GetValueOnGameThread() != 0;
+}
+
+int32 GlowScalability::GetMaxChainDepth()
+{
+	return FMath::Max(CVarMaxChainDepth.GetValueOnGameThread(), 0);
+}
+
+bool GlowScalability::IsRendered(const UWorld& World)
+{
+	return World.GetNetMode() != NM_DedicatedServer && FApp::CanEverRender() && !GUsingNullRHI;
+}
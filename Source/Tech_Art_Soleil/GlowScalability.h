@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+// Console variables scaling the glow pipeline, set per scalability level in DefaultScalability.ini
+// and per platform in DefaultDeviceProfiles.ini
+namespace GlowScalability
+{
+	// How many points the manager can have alive at once, never more than its capacity
+	int32 GetMaxManagerPoints(int32 Capacity);
+
+	// How many points a luminescent object can have alive at once, never more than its capacity
+	int32 GetMaxObjectPoints(int32 Capacity);
+
+	// Minimum time between two updates of the glow, 0 to update every frame
+	float GetUpdateInterval();
+
+	// Whether the times texture is stored in half floats, the points always need full floats for world positions
+	bool UseHalfPrecisionTimes();
+
+	// How many luminescent objects a hit can chain through, 0 to only light the object that was hit
+	int32 GetMaxChainDepth();
+
+	// Whether the glow is drawn at all, false on dedicated servers and null RHI runs where only the simulation runs
+	bool IsRendered(const UWorld& World);
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowTrace.h"
+
+#if GLOW_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(BioluminescenceChannel)
+
+// Sent again to late connections, so the timeline can always name the actors
+UE_TRACE_EVENT_BEGIN(Bioluminescence, OwnerInfo, NoSync|Important)
+	UE_TRACE_EVENT_FIELD(uint32, Id)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Bioluminescence, Hit)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint8, Source)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Bioluminescence, HitDropped)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint8, Reason)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Bioluminescence, PointStart)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint8, Slot)
+	UE_TRACE_EVENT_FIELD(uint8, Profile)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Bioluminescence, StageChange)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint8, Slot)
+	UE_TRACE_EVENT_FIELD(uint8, Stage)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Bioluminescence, PointEvict)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint8, Slot)
+	UE_TRACE_EVENT_FIELD(uint8, IntoSlot)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Bioluminescence, Upload)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, Owner)
+	UE_TRACE_EVENT_FIELD(uint16, NumPoints)
+UE_TRACE_EVENT_END()
+
+void GlowTrace::OutputOwner(const UObject& Owner)
+{
+	const FString Name = Owner.GetName();
+
+	UE_TRACE_LOG(Bioluminescence, OwnerInfo, BioluminescenceChannel)
+		<< OwnerInfo.Id(Owner.GetUniqueID())
+		<< OwnerInfo.Name(*Name, Name.Len());
+}
+
+void GlowTrace::OutputHit(const UObject& Owner, const EHitSource Source)
+{
+	UE_TRACE_LOG(Bioluminescence, Hit, BioluminescenceChannel)
+		<< Hit.Cycle(FPlatformTime::Cycles64())
+		<< Hit.Owner(Owner.GetUniqueID())
+		<< Hit.Source(static_cast<uint8>(Source));
+}
+
+void GlowTrace::OutputHitDropped(const UObject& Owner, const EDropReason Reason)
+{
+	UE_TRACE_LOG(Bioluminescence, HitDropped, BioluminescenceChannel)
+		<< HitDropped.Cycle(FPlatformTime::Cycles64())
+		<< HitDropped.Owner(Owner.GetUniqueID())
+		<< HitDropped.Reason(static_cast<uint8>(Reason));
+}
+
+void GlowTrace::OutputPointStart(const UObject& Owner, const size_t Slot, const uint8 ProfileIndex)
+{
+	UE_TRACE_LOG(Bioluminescence, PointStart, BioluminescenceChannel)
+		<< PointStart.Cycle(FPlatformTime::Cycles64())
+		<< PointStart.Owner(Owner.GetUniqueID())
+		<< PointStart.Slot(static_cast<uint8>(Slot))
+		<< PointStart.Profile(ProfileIndex);
+}
+
+void GlowTrace::OutputStageChange(const UObject& Owner, const size_t Slot, const uint8 Stage)
+{
+	UE_TRACE_LOG(Bioluminescence, StageChange, BioluminescenceChannel)
+		<< StageChange.Cycle(FPlatformTime::Cycles64())
+		<< StageChange.Owner(Owner.GetUniqueID())
+		<< StageChange.Slot(static_cast<uint8>(Slot))
+		<< StageChange.Stage(Stage);
+}
+
+void GlowTrace::OutputPointEvict(const UObject& Owner, const size_t Slot, const size_t IntoSlot)
+{
+	UE_TRACE_LOG(Bioluminescence, PointEvict, BioluminescenceChannel)
+		<< PointEvict.Cycle(FPlatformTime::Cycles64())
+		<< PointEvict.Owner(Owner.GetUniqueID())
+		<< PointEvict.Slot(static_cast<uint8>(Slot))
+		<< PointEvict.IntoSlot(static_cast<uint8>(IntoSlot));
+}
+
+void GlowTrace::OutputUpload(const UObject& Owner, const uint32 NumPoints)
+{
+	UE_TRACE_LOG(Bioluminescence, Upload, BioluminescenceChannel)
+		<< Upload.Cycle(FPlatformTime::Cycles64())
+		<< Upload.Owner(Owner.GetUniqueID())
+		<< Upload.NumPoints(static_cast<uint16>(NumPoints));
+}
+
+#endif
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+#define GLOW_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+/**
+ * Timeline of the glow events for Unreal Insights, on the Bioluminescence trace channel
+ *
+ * Record with -trace=default,Bioluminescence, then read the events back next to the CPU timings with the GlowTrace commandlet
+ * Each event is a few bytes: the cycle, the unique id of the owning actor, and the slot of the point when it has one
+ * With the channel off, every macro below is a single test of the channel
+ */
+namespace GlowTrace
+{
+	// Where a hit comes from
+	enum class EHitSource : uint8
+	{
+		Collision,
+		Player,
+		Water,
+		Hand,
+		Chain
+	};
+
+	// Why a hit didn't start a point
+	enum class EDropReason : uint8
+	{
+		// Within the ignore collision timer of a previous hit
+		Ignored,
+		// No live slot left
+		PoolFull
+	};
+
+	void OutputOwner(const UObject& Owner);
+	void OutputHit(const UObject& Owner, EHitSource Source);
+	void OutputHitDropped(const UObject& Owner, EDropReason Reason);
+	void OutputPointStart(const UObject& Owner, size_t Slot, uint8 ProfileIndex);
+	void OutputStageChange(const UObject& Owner, size_t Slot, uint8 Stage);
+	void OutputPointEvict(const UObject& Owner, size_t Slot, size_t IntoSlot);
+	void OutputUpload(const UObject& Owner, uint32 NumPoints);
+}
+
+#if GLOW_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(BioluminescenceChannel, TECH_ART_SOLEIL_API)
+
+#define GLOW_TRACE(Call) do { if (UE_TRACE_CHANNELEXPR_IS_ENABLED(BioluminescenceChannel)) { GlowTrace::Call; } } while (0)
+
+#define TRACE_GLOW_OWNER(Owner) GLOW_TRACE(OutputOwner(Owner))
+#define TRACE_GLOW_HIT(Owner, Source) GLOW_TRACE(OutputHit(Owner, GlowTrace::EHitSource::Source))
+#define TRACE_GLOW_HIT_DROPPED(Owner, Reason) GLOW_TRACE(OutputHitDropped(Owner, GlowTrace::EDropReason::Reason))
+#define TRACE_GLOW_POINT_START(Owner, Slot, ProfileIndex) GLOW_TRACE(OutputPointStart(Owner, Slot, ProfileIndex))
+#define TRACE_GLOW_STAGE_CHANGE(Owner, Slot, Stage) GLOW_TRACE(OutputStageChange(Owner, Slot, static_cast<uint8>(Stage)))
+#define TRACE_GLOW_POINT_EVICT(Owner, Slot, IntoSlot) GLOW_TRACE(OutputPointEvict(Owner, Slot, IntoSlot))
+#define TRACE_GLOW_UPLOAD(Owner, NumPoints) GLOW_TRACE(OutputUpload(Owner, NumPoints))
+
+#else
+
+#define TRACE_GLOW_OWNER(Owner)
+#define TRACE_GLOW_HIT(Owner, Source)
+#define TRACE_GLOW_HIT_DROPPED(Owner, Reason)
+#define TRACE_GLOW_POINT_START(Owner, Slot, ProfileIndex)
+#define TRACE_GLOW_STAGE_CHANGE(Owner, Slot, Stage)
+#define TRACE_GLOW_POINT_EVICT(Owner, Slot, IntoSlot)
+#define TRACE_GLOW_UPLOAD(Owner, NumPoints)
+
+#endif
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowWavefrontSubsystem.h"
+
+#include "LuminescentObject.h"
+#include "Tech_Art_Soleil.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pending wavefront events"), STAT_PendingWavefrontEvents, STATGROUP_Bioluminescence);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wavefront events run"), STAT_WavefrontEventsRun, STATGROUP_Bioluminescence);
+
+void UGlowWavefrontSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetTime();
+
+	// Events run here can schedule new ones, those already due run this frame too
+	while (!Events.IsEmpty() && Events.HeapTop().Time <= Now)
+	{
+		FEvent Event;
+		Events.HeapPop(Event, &UGlowWavefrontSubsystem::IsEarlier, EAllowShrinking::No);
+
+		ALuminescentObject* const Object = Event.Object.Get();
+		if (!Object)
+			continue;
+
+		INC_DWORD_STAT(STAT_WavefrontEventsRun);
+
+		switch (Event.Type)
+		{
+			case EEventType::Arrival:
+				// The point carries on from where the wave would be by now, even if this frame came late
+				Object->AddPropagationPoint(Event.Point, Event.MaxRange, Event.ChainDepth, Event.Visits.ToSharedRef(), Now - Event.StartTime);
+				break;
+
+			case EEventType::FadeOut:
+				Object->StartFadeOut(Event.Slot, Event.Serial);
+				break;
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PendingWavefrontEvents, Events.Num());
+}
+
+TStatId UGlowWavefrontSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGlowWavefrontSubsystem, STATGROUP_Tickables);
+}
+
+void UGlowWavefrontSubsystem::ScheduleArrival(
+	ALuminescentObject& Object,
+	const FVector& Point,
+	const float MaxRange,
+	const int32 ChainDepth,
+	const TSharedRef<FGlowChainVisits>& Visits,
+	const float Delay
+)
+{
+	const double Now = GetTime();
+
+	FEvent Event;
+	Event.Time = Now + Delay;
+	Event.Object = &Object;
+	Event.Type = EEventType::Arrival;
+	Event.Point = Point;
+	Event.MaxRange = MaxRange;
+	Event.ChainDepth = ChainDepth;
+	Event.StartTime = Now;
+	Event.Visits = Visits;
+
+	Events.HeapPush(MoveTemp(Event), &UGlowWavefrontSubsystem::IsEarlier);
+}
+
+void UGlowWavefrontSubsystem::ScheduleFadeOut(ALuminescentObject& Object, const size_t Slot, const uint32 Serial, const float Delay)
+{
+	FEvent Event;
+	Event.Time = GetTime() + Delay;
+	Event.Object = &Object;
+	Event.Type = EEventType::FadeOut;
+	Event.Slot = Slot;
+	Event.Serial = Serial;
+
+	Events.HeapPush(MoveTemp(Event), &UGlowWavefrontSubsystem::IsEarlier);
+}
+
+bool UGlowWavefrontSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+double UGlowWavefrontSubsystem::GetTime() const
+{
+	// Same clock as the ticks of the objects, so pauses and time dilation apply to the schedule too
+	return GetWorld()->GetTimeSeconds();
+}
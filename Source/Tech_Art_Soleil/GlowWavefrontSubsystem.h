@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "GlowWavefrontSubsystem.generated.h"
+
+class ALuminescentObject;
+
+// Objects a chain has already reached, shared by all of its links so the wave never comes back to one of them
+using FGlowChainVisits = TSet<TObjectKey<AActor>>;
+
+/**
+ * Schedules the moments luminescent objects change without having to tick: a chained propagation reaching a neighbour,
+ * and a point done waiting for its fade out
+ *
+ * Pending events sit in a single heap keyed by their time, adding one and running one are both O(log n)
+ * Objects in between stop ticking altogether, the wave wakes them when it physically reaches them
+ */
+UCLASS()
+class TECH_ART_SOLEIL_API UGlowWavefrontSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Adds the chained point to the object once the wave reaches it, Delay seconds from now
+	void ScheduleArrival(ALuminescentObject& Object, const FVector& Point, float MaxRange, int32 ChainDepth, const TSharedRef<FGlowChainVisits>& Visits, float Delay);
+
+	// Starts the fade out of a point once its delay is over, ignored if the slot started another point in between
+	void ScheduleFadeOut(ALuminescentObject& Object, size_t Slot, uint32 Serial, float Delay);
+
+	int32 GetNumPendingEvents() const { return Events.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EEventType : uint8
+	{
+		Arrival,
+		FadeOut
+	};
+
+	struct FEvent final
+	{
+		double Time = 0.;
+		TWeakObjectPtr<ALuminescentObject> Object;
+		EEventType Type = EEventType::Arrival;
+
+		// Arrival, the chain keeps starting from the same point and range whenever it arrives
+		FVector Point = FVector::ZeroVector;
+		float MaxRange = 0.f;
+		int32 ChainDepth = 0;
+		double StartTime = 0.;
+		TSharedPtr<FGlowChainVisits> Visits;
+
+		// Fade out
+		size_t Slot = 0;
+		uint32 Serial = 0;
+	};
+
+	static bool IsEarlier(const FEvent& A, const FEvent& B) { return A.Time < B.Time; }
+
+	double GetTime() const;
+
+	// Min heap on the event time
+	TArray<FEvent> Events;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HandContactDetector.h"
+
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "Components/PrimitiveComponent.h"
+
+FHandContactDetector::FHandContactDetector(TUniquePtr<IHandJointSource>&& InSource)
+	: Source(MoveTemp(InSource))
+{
+}
+
+FHandContactDetector::~FHandContactDetector() = default;
+
+void FHandContactDetector::Detect(
+	UWorld& World,
+	const float Time,
+	const TFunctionRef<bool(const UPrimitiveComponent&)> IsParticipant,
+	TArray<FContact>& OutContacts
+)
+{
+	OutContacts.Reset();
+
+	Source->GetJoints(World, Time, Positions, Radii);
+
+	if (WasTouching.Num() != Positions.Num())
+		WasTouching.Init(false, Positions.Num());
+
+	if (Positions.IsEmpty())
+		return;
+
+	// One overlap covering every joint finds all the candidates of the frame
+	FBox JointsBounds(Positions);
+	JointsBounds = JointsBounds.ExpandBy(FMath::Max(Radii) + ContactTolerance);
+
+	Overlaps.Reset();
+	World.OverlapMultiByObjectType(
+		Overlaps,
+		JointsBounds.GetCenter(),
+		FQuat::Identity,
+		FCollisionObjectQueryParams(FCollisionObjectQueryParams::AllObjects),
+		FCollisionShape::MakeBox(JointsBounds.GetExtent())
+	);
+
+	Candidates.Reset();
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* const Component = Overlap.GetComponent();
+		if (Component && IsParticipant(*Component))
+			Candidates.AddUnique(Component);
+	}
+
+	for (int32 Joint = 0; Joint < Positions.Num(); Joint++)
+	{
+		const FVector& Position = Positions[Joint];
+		const float TouchDistance = Radii[Joint] + ContactTolerance;
+
+		bool bTouching = false;
+		FContact Contact;
+
+		for (UPrimitiveComponent* const Candidate : Candidates)
+		{
+			// Bounds first, the collision distance is only measured for the candidates the joint can reach
+			if (Candidate->Bounds.GetBox().ComputeSquaredDistanceToPoint(Position) > FMath::Square(TouchDistance))
+				continue;
+
+			FVector ClosestPoint;
+			const float Distance = Candidate->GetDistanceToCollision(Position, ClosestPoint);
+			if (Distance >= 0.f && Distance <= TouchDistance)
+			{
+				bTouching = true;
+				Contact = { ClosestPoint, Candidate };
+				break;
+			}
+		}
+
+		// Only a joint that wasn't touching anything last frame starts a propagation
+		if (bTouching && !WasTouching[Joint])
+		{
+			const bool bMerged = OutContacts.ContainsByPredicate([this, &Contact](const FContact& Other) -> bool
+			{
+				return Other.Component == Contact.Component
+					&& FVector::DistSquared(Other.Point, Contact.Point) <= FMath::Square(CoalesceDistance);
+			});
+
+			if (!bMerged)
+				OutContacts.Add(Contact);
+		}
+
+		WasTouching[Joint] = bTouching;
+	}
+}
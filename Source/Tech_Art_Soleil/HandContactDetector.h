@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HandJointSource.h"
+
+class UPrimitiveComponent;
+struct FOverlapResult;
+
+/**
+ * Turns the tracked hand joints into glow contacts
+ *
+ * All the joints are tested at once: a single overlap around every joint finds the candidate participants,
+ * then each joint is only measured against the candidates whose bounds it is close to
+ * A contact is only reported when a joint starts touching, and contacts close to each other are merged
+ */
+class FHandContactDetector final
+{
+public:
+	struct FContact final
+	{
+		FVector Point;
+		UPrimitiveComponent* Component = nullptr;
+	};
+
+	explicit FHandContactDetector(TUniquePtr<IHandJointSource>&& InSource);
+	~FHandContactDetector();
+
+	// Contacts that started this frame, with participants only
+	void Detect(UWorld& World, float Time, TFunctionRef<bool(const UPrimitiveComponent&)> IsParticipant, TArray<FContact>& OutContacts);
+
+	// Distance from the joint surface still counted as touching
+	float ContactTolerance = 0.5f;
+
+	// Contacts on the same component closer than this are merged into one
+	float CoalesceDistance = 8.f;
+
+private:
+	TUniquePtr<IHandJointSource> Source;
+
+	// Kept between frames so the detection doesn't allocate
+	TArray<FVector> Positions;
+	TArray<float> Radii;
+	TArray<FOverlapResult> Overlaps;
+	TArray<UPrimitiveComponent*> Candidates;
+
+	// Whether each joint was already touching a participant last frame
+	TBitArray<> WasTouching;
+};
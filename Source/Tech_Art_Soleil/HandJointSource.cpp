@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HandJointSource.h"
+
+#include "HeadMountedDisplayFunctionLibrary.h"
+#include "Tech_Art_Soleil.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/FileHelper.h"
+
+void FOpenXRHandJointSource::GetJoints(UWorld& World, float, TArray<FVector>& OutPositions, TArray<float>& OutRadii)
+{
+	OutPositions.Reset();
+	OutRadii.Reset();
+
+	for (const EControllerHand Hand : { EControllerHand::Left, EControllerHand::Right })
+	{
+		FXRMotionControllerData Data;
+		UHeadMountedDisplayFunctionLibrary::GetMotionControllerData(&World, Hand, Data);
+
+		if (!Data.bValid || Data.DeviceVisualType != EXRVisualType::Hand)
+			continue;
+
+		OutPositions.Append(Data.HandKeyPositions);
+		OutRadii.Append(Data.HandKeyRadii);
+
+		// Some runtimes don't report the joint radii
+		OutRadii.SetNum(OutPositions.Num());
+	}
+}
+
+FRecordedHandJointSource::FRecordedHandJointSource(TArray<FFrame>&& InFrames)
+	: Frames(MoveTemp(InFrames))
+{
+}
+
+TUniquePtr<FRecordedHandJointSource> FRecordedHandJointSource::LoadFromFile(const FString& Path)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("Could not load the hand joint stream %s"), *Path);
+		return nullptr;
+	}
+
+	TArray<FFrame> Frames;
+	TArray<FString> Values;
+
+	for (const FString& Line : Lines)
+	{
+		Line.ParseIntoArray(Values, TEXT(","));
+
+		// The time, then four values per joint
+		if (Values.Num() < 5 || (Values.Num() - 1) % 4 != 0)
+			continue;
+
+		FFrame& Frame = Frames.AddDefaulted_GetRef();
+		Frame.Time = FCString::Atof(*Values[0]);
+
+		for (int32 i = 1; i < Values.Num(); i += 4)
+		{
+			Frame.Positions.Emplace(FCString::Atod(*Values[i]), FCString::Atod(*Values[i + 1]), FCString::Atod(*Values[i + 2]));
+			Frame.Radii.Add(FCString::Atof(*Values[i + 3]));
+		}
+	}
+
+	if (Frames.IsEmpty())
+	{
+		UE_LOG(LogBioluminescence, Warning, TEXT("The hand joint stream %s has no valid frame"), *Path);
+		return nullptr;
+	}
+
+	return MakeUnique<FRecordedHandJointSource>(MoveTemp(Frames));
+}
+
+TUniquePtr<FRecordedHandJointSource> FRecordedHandJointSource::MakeTapping(const FVector& Center, const float Period)
+{
+	constexpr int32 NumFrames = 30;
+	constexpr int32 NumFingers = 5;
+	constexpr float FingerSpacing = 2.f;
+	constexpr float TapHeight = 10.f;
+	constexpr float FingertipRadius = 0.8f;
+
+	TArray<FFrame> Frames;
+	Frames.Reserve(NumFrames);
+
+	for (int32 i = 0; i < NumFrames; i++)
+	{
+		FFrame& Frame = Frames.AddDefaulted_GetRef();
+		Frame.Time = Period * i / NumFrames;
+
+		// Goes from TapHeight above the point to slightly below it, and back
+		const float Height = TapHeight * FMath::Cos(UE_TWO_PI * i / NumFrames) - FingertipRadius;
+
+		for (int32 Finger = 0; Finger < NumFingers; Finger++)
+		{
+			const float Offset = (Finger - NumFingers / 2) * FingerSpacing;
+			Frame.Positions.Add(Center + FVector(0.f, Offset, Height));
+			Frame.Radii.Add(FingertipRadius);
+		}
+	}
+
+	return MakeUnique<FRecordedHandJointSource>(MoveTemp(Frames));
+}
+
+void FRecordedHandJointSource::GetJoints(UWorld&, const float Time, TArray<FVector>& OutPositions, TArray<float>& OutRadii)
+{
+	// Frames are sorted by time, and a stream always loops one frame duration after its last frame
+	const float FrameDuration = Frames.Num() > 1 ? Frames[1].Time - Frames[0].Time : 1.f;
+	const float Duration = Frames.Last().Time - Frames[0].Time + FrameDuration;
+	const float LoopTime = Frames[0].Time + FMath::Fmod(Time, Duration);
+
+	const int32 Index = FMath::Max(Algo::UpperBoundBy(Frames, LoopTime, &FFrame::Time) - 1, 0);
+
+	OutPositions = Frames[Index].Positions;
+	OutRadii = Frames[Index].Radii;
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Provides the position of every tracked hand joint, once per frame
+ */
+class IHandJointSource
+{
+public:
+	virtual ~IHandJointSource() = default;
+
+	// World space position and radius of each tracked joint, empty if no hand is tracked
+	virtual void GetJoints(UWorld& World, float Time, TArray<FVector>& OutPositions, TArray<float>& OutRadii) = 0;
+};
+
+/**
+ * Joints of both hands, as tracked by the OpenXR runtime
+ */
+class FOpenXRHandJointSource final : public IHandJointSource
+{
+public:
+	virtual void GetJoints(UWorld& World, float Time, TArray<FVector>& OutPositions, TArray<float>& OutRadii) override;
+};
+
+/**
+ * Replays a recorded or synthetic joint stream, so the hand contacts can be tested without any headset
+ */
+class FRecordedHandJointSource final : public IHandJointSource
+{
+public:
+	struct FFrame final
+	{
+		float Time = 0.f;
+		TArray<FVector> Positions;
+		TArray<float> Radii;
+	};
+
+	explicit FRecordedHandJointSource(TArray<FFrame>&& InFrames);
+
+	// Loads a stream with one frame per line: the time, then X, Y, Z and radius of each joint, comma separated
+	static TUniquePtr<FRecordedHandJointSource> LoadFromFile(const FString& Path);
+
+	// Five fingertips tapping down through a point and back up, once per period
+	static TUniquePtr<FRecordedHandJointSource> MakeTapping(const FVector& Center, float Period);
+
+	// Loops over the stream, holding each frame until the next one starts
+	virtual void GetJoints(UWorld& World, float Time, TArray<FVector>& OutPositions, TArray<float>& OutRadii) override;
+
+private:
+	TArray<FFrame> Frames;
+};
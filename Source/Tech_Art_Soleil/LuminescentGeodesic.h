@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EngineDefines.h"
+
+// Layout of the surface distances baked into the luminescent meshes by the geodesic bake commandlet
+// The material reads the same channels, so any change here needs the material to be updated too
+namespace LuminescentGeodesic
+{
+	// First UV channel holding baked distances, channels 0 and 1 are left for the texture and lightmap UVs
+	constexpr int32 FirstUVChannel = 2;
+
+	// Each UV channel holds the distance to two sources, one in U and one in V
+	constexpr int32 SourcesPerChannel = 2;
+
+	// Maximum number of sources a single mesh can have baked
+	constexpr int32 MaxSources = (MAX_STATIC_TEXCOORDS - FirstUVChannel) * SourcesPerChannel;
+
+	// UV channel holding the distance to a given source
+	constexpr int32 GetUVChannel(const int32 SourceIndex)
+	{
+		return FirstUVChannel + SourceIndex / SourcesPerChannel;
+	}
+
+	// UV component (0 for U, 1 for V) holding the distance to a given source
+	constexpr int32 GetUVComponent(const int32 SourceIndex)
+	{
+		return SourceIndex % SourcesPerChannel;
+	}
+}
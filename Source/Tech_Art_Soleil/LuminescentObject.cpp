@@ -1,34 +1,62 @@
 #include "LuminescentObject.h"
 
-#include "Engine/Canvas.h"
-#include "Kismet/KismetMathLibrary.h"
+#include "GlowCurveSubsystem.h"
+#include "GlowOcclusionSubsystem.h"
+#include "GlowPointAtlasSubsystem.h"
+#include "GlowScalability.h"
+#include "GlowTrace.h"
+#include "GlowWavefrontSubsystem.h"
+#include "LuminescentGeodesic.h"
+#include "Tech_Art_Soleil.h"
 #include "Kismet/KismetRenderingLibrary.h"
 #include "Kismet/KismetSystemLibrary.h"
 
+namespace
+{
+	// Whether the material reads the parameter, the features the C++ side can switch need the material to support them
+	bool HasScalarParameter(const UMaterialInterface& Material, const FName Name)
+	{
+		TArray<FMaterialParameterInfo> ParameterInfos;
+		TArray<FGuid> ParameterIds;
+		Material.GetAllScalarParameterInfo(ParameterInfos, ParameterIds);
+
+		return ParameterInfos.ContainsByPredicate([Name](const FMaterialParameterInfo& Info) -> bool
+		{
+			return Info.Name == Name;
+		});
+	}
+}
+
 ALuminescentObject::ALuminescentObject()
 {
 	PrimaryActorTick.bCanEverTick = true;
+
+	// Only the propagation starts are replicated, see MulticastStartPropagation
+	bReplicates = true;
+
+	// Only ticks while a point moves, see WakeUp
+	PrimaryActorTick.bStartWithTickEnabled = false;
 }
 
 void ALuminescentObject::BeginPlay()
 {
 	Super::BeginPlay();
 
+	TRACE_GLOW_OWNER(*this);
+
+	Wavefront = GetWorld()->GetSubsystem<UGlowWavefrontSubsystem>();
+	PointAtlas = GetWorld()->GetSubsystem<UGlowPointAtlasSubsystem>();
+	Occlusion = GetWorld()->GetSubsystem<UGlowOcclusionSubsystem>();
+
+	// Chains run between luminescent objects, the occlusion field has to cover all of them
+	if (Occlusion)
+		Occlusion->IncludeBounds(GetComponentsBoundingBox());
+
 	MeshComponent = GetComponentByClass<UStaticMeshComponent>();
 	if (!MeshComponent)
 		return;
 
 	MeshComponent->OnComponentHit.AddDynamic(this, &ALuminescentObject::OnHit);
-	Material = MeshComponent->CreateDynamicMaterialInstance(0, LuminescentMaterial);
-
-	// Set initial propagation speed value
-	Material->SetScalarParameterValue(TEXT("PropagationSpeed"), PropagationSpeed);
-
-	// Set max propagation distance
-	Material->SetScalarParameterValue(TEXT("MaxPropagationDistance"), PropagationDistance);
-
-	// Set brightness
-	Material->SetScalarParameterValue(TEXT("Brightness"), IntensityRatio);
 
 	// Compute the time it will take to finish the propagation
 	TotalPropagationTime = PropagationDistance / PropagationSpeed;
@@ -36,18 +64,53 @@ void ALuminescentObject::BeginPlay()
 	// Ratio between the total propagation time, and the fade out duration
 	FadeOutTimeRatio = TotalPropagationTime / FadeOutDuration;
 
-	SetupRenderTarget();
+	// The own values are profile 0, a profile set only adds the surfaces that differ from them
+	OwnProfile = FGlowPropagationProfile(PropagationDistance, PropagationSpeed, IntensityRatio, FadeOutDelay, FadeOutDuration);
+
+	// Bake the curves once, so neither the CPU nor the shader evaluates them afterwards
+	PropagationTable.Bake(PropagationCurve, [](const float Time) -> float { return FMath::InterpEaseOut(0.f, 1.f, Time, 3.f); });
+	FadeOutTable.Bake(FadeOutCurve, [](const float Time) -> float { return Time; });
+
+	// Without rendering the object only simulates its points, for the events and the chains
+	if (GlowScalability::IsRendered(*GetWorld()))
+		SetupMaterial();
+
+	if (ULuminescentSignificanceSubsystem* const Significance = GetWorld()->GetSubsystem<ULuminescentSignificanceSubsystem>())
+		Significance->RegisterObject(this);
+}
+
+void ALuminescentObject::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ULuminescentSignificanceSubsystem* const Significance = GetWorld()->GetSubsystem<ULuminescentSignificanceSubsystem>())
+		Significance->UnregisterObject(this);
+
+	if (AtlasRow != INDEX_NONE)
+		PointAtlas->ReleaseRow(AtlasRow);
+	else if (PointBuffer)
+		PointBuffer->Release();
+
+	AtlasRow = INDEX_NONE;
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ALuminescentObject::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (!Material)
+	if (!MeshComponent)
 	{
-		// Don't want to do anything if the material isn't valid
+		// Don't want to do anything without a mesh to glow on
+		SetActorTickEnabled(false);
 		return;
 	}
+
+	// Measured on the world clock rather than taken from the tick, which doesn't count the time spent asleep
+	const double Now = GetWorld()->GetTimeSeconds();
+	const float StepTime = Now - LastAdvanceTime;
+	LastAdvanceTime = Now;
+
+	bool bAnyPointMoving = false;
 	
 	for (size_t i = 0; i < PropagationPoints.size(); i++)
 	{
@@ -55,6 +118,8 @@ void ALuminescentObject::Tick(const float DeltaTime)
 		//UE_LOG(LogTemp, Display, TEXT("Point %llu: Stage : %lld | Timer : %f"),i,p.Stage, p.PropagationTime);
 		// Easing functions from https://easings.net/en
 
+		const EPropagationStage PreviousStage = p.Stage;
+
 		// First update the propagation point
 		switch (p.Stage)
 		{
@@ -62,28 +127,56 @@ void ALuminescentObject::Tick(const float DeltaTime)
 				break;
 
 			case EPropagationStage::Active:
-				ProcessPropagation(p, DeltaTime);
+				ProcessPropagation(p, StepTime);
 				break;
 
 			case EPropagationStage::WaitingForFadeOut:
-				p.FadeOutTimer -= DeltaTime;
+				// The wavefront subsystem ends the wait, see StartFadeOut
+				if (Wavefront)
+					break;
+
+				p.FadeOutTimer -= StepTime;
 				if (p.FadeOutTimer <= 0)
 					p.Stage = EPropagationStage::FadeOut;
 				break;
 
 			case EPropagationStage::FadeOut:
-				ProcessFadeOut(p, DeltaTime);
+				ProcessFadeOut(p, StepTime);
+		}
+
+		if (p.Stage != PreviousStage)
+		{
+			TRACE_GLOW_STAGE_CHANGE(*this, i, p.Stage);
+
+			if (p.Stage == EPropagationStage::WaitingForFadeOut && Wavefront)
+				Wavefront->ScheduleFadeOut(*this, i, p.Serial, p.FadeOutTimer);
 		}
 
-		//UE_LOG(LogTemp, Display, TEXT("Point %d: time : %f Stage : %lld (%f, %f, %f)"), i, p.TimeToSend, p.Stage, p.HitPoint.X, p.HitPoint.Y, p.HitPoint.Z);
+		const bool bWaiting = p.Stage == EPropagationStage::WaitingForFadeOut && Wavefront;
+		if (p.Stage != EPropagationStage::Inactive && !bWaiting)
+			bAnyPointMoving = true;
+
+		//UE_LOG(LogTemp, Display, TEXT("Point %d: time : %f Stage : %lld (%f, %f, %f)"), i, p.TimeToSend, p.Stage, p.LocalHitPoint.X, p.LocalHitPoint.Y, p.LocalHitPoint.Z);
+	}
+
+	// Nothing changes until the wavefront subsystem or a new point wakes the object up
+	if (!bAnyPointMoving)
+		SetActorTickEnabled(false);
+
+	// Nothing is drawn, the simulation is all there is
+	if (!PointBuffer)
+		return;
+
+	if (UpdateTier == ELuminescentUpdateTier::Hidden)
+	{
+		// Nobody can see the glow, upload it once the object shows up again
+		PointsDirty = true;
+		return;
 	}
 
 	// Send data to the textures
 	SendPointsToShader();
-	SendTimesToShader();
-	
-	Material->SetTextureParameterValue("PointsArray", PointsTexture);
-	Material->SetTextureParameterValue("TimesArray", TimesTexture);
+	PointsDirty = false;
 }
 
 void ALuminescentObject::OnHit(
@@ -94,142 +187,397 @@ void ALuminescentObject::OnHit(
 	const FHitResult& Hit
 )
 {
-	if (IgnoreCollision)
+	// The server is the only one deciding when a hit starts a propagation, clients get it through the multicast
+	if (!HasAuthority())
 		return;
+
+	TRACE_GLOW_HIT(*this, Collision);
+	if (IsIgnoringCollision())
+	{
+		TRACE_GLOW_HIT_DROPPED(*this, Ignored);
+		return;
+	}
 	
-	FVector BodyPoint;
-	MeshComponent->GetClosestPointOnCollision(Hit.Location, BodyPoint);
+	// The impact point is already on the surface of the mesh, unlike the location of a sweep
+	const FVector BodyPoint = Hit.ImpactPoint;
 
-	const float MaxRange = OtherActor->GetTransform().GetTranslation().Length() * IntensityRatio;
+	const uint8 ProfileIndex = FindProfileIndex(MeshComponent, &Hit);
+	const float MaxRange = OtherActor->GetTransform().GetTranslation().Length() * GetProfile(ProfileIndex).IntensityRatio;
 	
-	TryStartPropagation(BodyPoint, MaxRange);
-	IgnoreCollision = true;
+	StartPropagation(BodyPoint, MaxRange, ProfileIndex);
+}
 
-	FTimerHandle Handle;
-	GetWorldTimerManager().SetTimer(Handle,
-		[this]() -> void { IgnoreCollision = false; },
-	IgnoreCollisionTimer, false);
+void ALuminescentObject::StartPropagation(const FVector& BodyPoint, const float MaxRange, const uint8 ProfileIndex)
+{
+	if (IsIgnoringCollision())
+	{
+		TRACE_GLOW_HIT_DROPPED(*this, Ignored);
+		return;
+	}
+
+	// The server shares its propagations, clients only show their own locally
+	// The server simulates the quantized event too, or its glow would drift from what clients show
+	if (HasAuthority())
+		MulticastStartPropagation(FPropagationEvent(MeshComponent->GetComponentTransform().InverseTransformPosition(BodyPoint), MaxRange, false, ProfileIndex).Quantize());
+	else
+		TryStartPropagation(BodyPoint, MaxRange, ProfileIndex);
+
+	IgnoreCollisions();
+}
+
+void ALuminescentObject::MulticastStartPropagation_Implementation(const FPropagationEvent& Event)
+{
+	UE_LOG(LogBioluminescence, Verbose, TEXT("%s: propagation event at local (%s), %lld bits"), *GetName(), *Event.StartPoint.ToString(), Event.GetSerializedBits());
+
+	// The event can only be placed on the mesh it is relative to
+	if (!MeshComponent)
+		return;
+
+	const FVector BodyPoint = MeshComponent->GetComponentTransform().TransformPosition(Event.StartPoint);
+	const float MaxRange = Event.MaxRange;
+
+	TryStartPropagation(BodyPoint, MaxRange, Event.ProfileIndex);
+
+	// Neighbours propagate with their own values, the profile indices of this object mean nothing to them
+	// The chain only depends on the event, so every machine finds the same neighbours without replicating them
+	const TSharedRef<FGlowChainVisits> Visits = MakeShared<FGlowChainVisits>();
+	Visits->Add(this);
+	ChainToNeighbours(BodyPoint, MaxRange, 1, Visits);
+}
+
+void ALuminescentObject::ChainToNeighbours(const FVector& Point, const float MaxRange, const int32 Depth, const TSharedRef<FGlowChainVisits>& Visits)
+{
+	if (Depth > GlowScalability::GetMaxChainDepth())
+		return;
 
 	TArray<AActor*> LuminescentObjects;
 	
 	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectType;
 	ObjectType.Add(UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_WorldDynamic));
 	ObjectType.Add(UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_PhysicsBody));
-	UKismetSystemLibrary::SphereOverlapActors(this, BodyPoint, MaxRange, ObjectType, StaticClass(), {this}, LuminescentObjects);
+	UKismetSystemLibrary::SphereOverlapActors(this, Point, MaxRange, ObjectType, StaticClass(), {this}, LuminescentObjects);
+
+	// Without this the next link would bounce the wave back to the objects before it, and onto the one it started from
+	LuminescentObjects.RemoveAll([&Visits](const AActor* const Actor) -> bool { return Visits->Contains(Actor); });
+
+	// The wave doesn't go through walls or rocks, every neighbour is tested against the occlusion field at once
+	TArray<bool, TInlineAllocator<16>> Occluded;
+	Occluded.Init(false, LuminescentObjects.Num());
 
-	for (AActor* const Actor : LuminescentObjects)
+	if (const FGlowOcclusionField* const Field = Occlusion ? Occlusion->GetField() : nullptr)
 	{
-		ALuminescentObject* const LuminescentObject = Cast<ALuminescentObject>(Actor);
-		LuminescentObject->AddPropagationPoint(BodyPoint, MaxRange);
+		TArray<FVector, TInlineAllocator<16>> From;
+		TArray<FVector, TInlineAllocator<16>> To;
+
+		for (const AActor* const Actor : LuminescentObjects)
+		{
+			From.Add(Point);
+			To.Add(Actor->GetComponentsBoundingBox().GetCenter());
+		}
+
+		Field->TestOcclusion(From, To, Occluded);
 	}
 
-}
+	for (int32 i = 0; i < LuminescentObjects.Num(); i++)
+	{
+		if (Occluded[i])
+			continue;
 
-void ALuminescentObject::SetupRenderTarget()
-{
-	// Allocate a texture big enough to hold our max number of points
-	PointsTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, RTF_RGBA32f); 
-	TimesTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, RTF_RGBA32f);
+		ALuminescentObject* const LuminescentObject = Cast<ALuminescentObject>(LuminescentObjects[i]);
+
+		// Claimed now rather than on arrival, so two links reaching it in the same wave don't both light it
+		Visits->Add(LuminescentObject);
+
+		// Each neighbour only starts when the wave reaches it, until then it doesn't cost anything
+		if (Wavefront)
+			Wavefront->ScheduleArrival(*LuminescentObject, Point, MaxRange, Depth, Visits, LuminescentObject->GetArrivalDelay(Point));
+		else
+			LuminescentObject->AddPropagationPoint(Point, MaxRange, Depth, Visits, 0.f);
+	}
 }
 
-void ALuminescentObject::SendPointsToShader()
+void ALuminescentObject::SetupMaterial()
 {
-	SendToShader(PointsTexture, [](const FPropagationPointStatus& Point) -> FLinearColor
-	{
-		constexpr FLinearColor ColorEmpty = FLinearColor(-1.f, -1.f, -1.f, -1.f);
+	Material = MeshComponent->CreateDynamicMaterialInstance(0, LuminescentMaterial);
+
+	// Set initial propagation speed value
+	Material->SetScalarParameterValue(TEXT("PropagationSpeed"), PropagationSpeed);
+
+	// Set max propagation distance
+	Material->SetScalarParameterValue(TEXT("MaxPropagationDistance"), PropagationDistance);
 
-		return Point.Stage != EPropagationStage::Inactive
-			? FLinearColor(Point.HitPoint.X, Point.HitPoint.Y, Point.HitPoint.Z, 1.0f)
-			: ColorEmpty;
-	});
+	// Set brightness
+	Material->SetScalarParameterValue(TEXT("Brightness"), IntensityRatio);
+
+	SetupRenderTarget();
+
+	bLocalSpacePoints = HasScalarParameter(*Material, TEXT("LocalSpacePoints"));
+
+	// The textures never change, only their content does, so bind them once
+	Material->SetTextureParameterValue("PointsArray", PointsTexture);
+	Material->SetTextureParameterValue("TimesArray", TimesTexture);
+	Material->SetTextureParameterValue("PropagationCurves", CurvesTexture);
+
+	// The material reads its points from a single row of the textures, the only one when the object owns them
+	Material->SetScalarParameterValue(TEXT("AtlasRow"), static_cast<float>(FMath::Max(AtlasRow, 0)));
+	Material->SetScalarParameterValue(TEXT("AtlasRows"), static_cast<float>(AtlasRow != INDEX_NONE ? PointAtlas->GetNumRows() : 1));
+
+	// Shared by every glow using the same set
+	if (ProfileSet)
+		Material->SetTextureParameterValue("PropagationProfiles", ProfileSet->GetTexture());
 }
 
-void ALuminescentObject::SendTimesToShader()
+void ALuminescentObject::SetupRenderTarget()
 {
-	SendToShader(TimesTexture, [](const FPropagationPointStatus& Point) -> FLinearColor
+	// Shared with every glow using the same curves, only a world without the subsystem gets a texture of its own
+	UGlowCurveSubsystem* const Curves = GetWorld()->GetSubsystem<UGlowCurveSubsystem>();
+	CurvesTexture = Curves
+		? Curves->GetTexture(PropagationCurve, FadeOutCurve, PropagationTable, FadeOutTable)
+		: FGlowCurveTable::CreateTexture(PropagationTable, FadeOutTable);
+
+	// A row of the shared atlas rather than two tiny textures, uploaded along with every other object
+	// Materials that don't read the row would sample the middle of the atlas, they keep textures of their own
+	if (PointAtlas && HasScalarParameter(*Material, TEXT("AtlasRow")))
 	{
-		constexpr FLinearColor ColorEmpty = FLinearColor(-1.f, -1.f, -1.f, -1.f);
+		PointBuffer = FGlowPointBuffer::CreateUnbound(MaxNumberPropagationPoints);
+		AtlasRow = PointAtlas->AllocateRow(PointBuffer.ToSharedRef());
+
+		if (AtlasRow != INDEX_NONE)
+		{
+			PointsTexture = PointAtlas->GetPointsTexture();
+			TimesTexture = PointAtlas->GetTimesTexture();
+			return;
+		}
+	}
+
+	// Allocate a texture big enough to hold our max number of points
+	// Positions need full floats, the times can go down to half floats on cheaper platforms
+	const bool bHalfPrecisionTimes = GlowScalability::UseHalfPrecisionTimes();
+	PointsTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, RTF_RGBA32f); 
+	TimesTexture = UKismetRenderingLibrary::CreateRenderTarget2D(this, MaxNumberPropagationPoints, 1, bHalfPrecisionTimes ? RTF_RGBA16f : RTF_RGBA32f);
 
-		return Point.Stage != EPropagationStage::Inactive
-			? FLinearColor(Point.TimeToSend, Point.FadeOutIntensity, Point.PropagationDistance, 0.0f)
-			: ColorEmpty;
-	});
+	PointBuffer = FGlowPointBuffer::Create(PointsTexture, TimesTexture, MaxNumberPropagationPoints, bHalfPrecisionTimes);
 }
 
-void ALuminescentObject::SendToShader(UTextureRenderTarget2D* const Texture, const std::function<FLinearColor(const FPropagationPointStatus&)>& Lambda)
+void ALuminescentObject::SendPointsToShader()
 {
-	FVector2D _;
-	FDrawToRenderTargetContext Context;
+	// Only a copy into the snapshot happens here, the upload itself is done by the render thread
+	FGlowPointBuffer::FSnapshot& Snapshot = PointBuffer->GetWriteSnapshot();
+	uint32 NumLivePoints = 0;
+
+	const FTransform& Transform = MeshComponent->GetComponentTransform();
+	const FVector Scale = Transform.GetScale3D();
 
-	UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, Texture, TimesCanvas, _, Context);
-	UKismetRenderingLibrary::ClearRenderTarget2D(this, Texture);
-	
 	for (size_t i = 0; i < PropagationPoints.size(); i++)
 	{
 		const FPropagationPointStatus& p = PropagationPoints[i];
 
-		if (p.Stage != EPropagationStage::Inactive)
+		if (p.Stage == EPropagationStage::Inactive)
 		{
-			// Get result data
-			const FLinearColor Data = Lambda(p);
-
-			// Write color to texture
-			TimesCanvas->K2_DrawBox(FVector2d(i + 0.5f, 0.f), FVector2D::One(), 1.f , Data);
+			Snapshot.Points[i] = FGlowPointBuffer::EmptyTexel;
+			Snapshot.Times[i] = FGlowPointBuffer::EmptyTexel;
+			continue;
 		}
+
+		// Relative to the mesh, the material brings them to the world with its rotation and location, so moving it doesn't
+		// rewrite them, the scale is already applied so the ranges and fronts stay in world units
+		const FVector Point = bLocalSpacePoints ? p.LocalHitPoint * Scale : Transform.TransformPosition(p.LocalHitPoint);
+
+		// Alpha of the times holds the baked source, offset by one so 0 keeps meaning the straight-line distance
+		// A live point keeps a non zero alpha, as cleared texels are 0, the material reads the profile as alpha - 1
+		Snapshot.Points[i] = FVector4f(Point.X, Point.Y, Point.Z, p.ProfileIndex + 1.0f);
+		Snapshot.Times[i] = FVector4f(p.TimeToSend, p.FadeOutIntensity, p.PropagationDistance, p.SourceIndex + 1.0f);
+		NumLivePoints++;
 	}
 
-	UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+	PointBuffer->Publish();
+	TRACE_GLOW_UPLOAD(*this, NumLivePoints);
 }
 
-void ALuminescentObject::AddPropagationPoint(const FVector& Point, const float MaxRange)
+void ALuminescentObject::AddPropagationPoint(
+	const FVector& Point,
+	const float MaxRange,
+	const int32 ChainDepth,
+	const TSharedRef<FGlowChainVisits>& Visits,
+	const float ElapsedTime
+)
 {
-	TryStartPropagation(Point, MaxRange);
-	IgnoreCollision = true;
-
-	FTimerHandle Handle;
-	GetWorldTimerManager().SetTimer(Handle,
-		[this]() -> void { IgnoreCollision = false; },
-	IgnoreCollisionTimer, false);
+	TRACE_GLOW_HIT(*this, Chain);
+	TryStartPropagation(Point, MaxRange, 0, ElapsedTime);
+	IgnoreCollisions();
+
+	// Deeper links of the chain carry on from this object, with whatever is left of the range
+	const float RemainingRange = MaxRange - FVector::Dist(Point, GetActorLocation());
+	if (RemainingRange > 0.f)
+		ChainToNeighbours(GetActorLocation(), RemainingRange, ChainDepth + 1, Visits);
 }
 
-void ALuminescentObject::TryStartPropagation(const FVector& StartPoint, const float MaxRange)
+void ALuminescentObject::TryStartPropagation(const FVector& StartPoint, const float MaxRange, const uint8 ProfileIndex, const float ElapsedTime)
 {
-	for (size_t i = 0; i < PropagationPoints.size(); i++)
+	const size_t MaxLivePoints = GlowScalability::GetMaxObjectPoints(MaxNumberPropagationPoints);
+	for (size_t i = 0; i < MaxLivePoints; i++)
 	{
 		if (PropagationPoints[i].Stage == EPropagationStage::Inactive)
 		{
-			SetupPropagationPoint(StartPoint, PropagationPoints[i], MaxRange);
-			break;
+			SetupPropagationPoint(StartPoint, PropagationPoints[i], MaxRange, ProfileIndex);
+			PropagationPoints[i].PropagationTime = ElapsedTime;
+			TRACE_GLOW_POINT_START(*this, i, ProfileIndex);
+			WakeUp();
+			return;
 		}
 	}
+
+	TRACE_GLOW_HIT_DROPPED(*this, PoolFull);
 }
 
-void ALuminescentObject::SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange) const
+void ALuminescentObject::SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange, const uint8 ProfileIndex) const
 {
 	Point.Stage = EPropagationStage::Active;
+	Point.ProfileIndex = ProfileIndex;
 	Point.PropagationTime = 0.f;
-	Point.HitPoint = StartPoint;
+	Point.LocalHitPoint = MeshComponent ? MeshComponent->GetComponentTransform().InverseTransformPosition(StartPoint) : StartPoint;
 	Point.PropagationDistance = MaxRange;
+	Point.SourceIndex = FindNearestLocalBakedSource(Point.LocalHitPoint);
+	Point.Serial++;
+}
+
+void ALuminescentObject::StartFadeOut(const size_t Slot, const uint32 Serial)
+{
+	FPropagationPointStatus& Point = PropagationPoints[Slot];
+
+	// The slot may have ended, or started another point, since the fade out was scheduled
+	if (Point.Stage != EPropagationStage::WaitingForFadeOut || Point.Serial != Serial)
+		return;
+
+	Point.Stage = EPropagationStage::FadeOut;
+	TRACE_GLOW_STAGE_CHANGE(*this, Slot, Point.Stage);
+	WakeUp();
+}
+
+float ALuminescentObject::GetArrivalDelay(const FVector& Point) const
+{
+	FVector ClosestPoint;
+	const float Distance = MeshComponent ? MeshComponent->GetDistanceToCollision(Point, ClosestPoint) : -1.f;
+	if (Distance <= 0.f)
+		return 0.f;
+
+	// Chained points propagate with the own values, the wave arrives when their front covers the distance
+	const float TotalTime = OwnProfile.GetTotalPropagationTime();
+	const float Coverage = Distance / OwnProfile.PropagationDistance;
+	if (Coverage >= 1.f)
+		return TotalTime;
+
+	// The propagation curve only goes up, so its inverse is found by bisection
+	float Low = 0.f;
+	float High = 1.f;
+	for (int32 i = 0; i < 16; i++)
+	{
+		const float Middle = 0.5f * (Low + High);
+		if (PropagationTable.Evaluate(Middle) < Coverage)
+			Low = Middle;
+		else
+			High = Middle;
+	}
+
+	return High * TotalTime;
+}
+
+void ALuminescentObject::WakeUp()
+{
+	if (IsActorTickEnabled())
+		return;
+
+	// The time asleep isn't part of the next step
+	LastAdvanceTime = GetWorld()->GetTimeSeconds();
+	SetActorTickEnabled(true);
+}
+
+bool ALuminescentObject::IsIgnoringCollision() const
+{
+	return GetWorld()->GetTimeSeconds() < IgnoreCollisionEndTime;
+}
+
+void ALuminescentObject::IgnoreCollisions()
+{
+	IgnoreCollisionEndTime = GetWorld()->GetTimeSeconds() + IgnoreCollisionTimer;
+}
+
+const FGlowPropagationProfile& ALuminescentObject::GetProfile(const uint8 ProfileIndex) const
+{
+	return ProfileIndex == 0 || !ProfileSet ? OwnProfile : ProfileSet->GetProfile(ProfileIndex);
+}
+
+uint8 ALuminescentObject::FindProfileIndex(const UPrimitiveComponent* const Component, const FHitResult* const Hit) const
+{
+	return ProfileSet ? ProfileSet->FindProfileIndex(UGlowProfileSet::ResolvePhysicalMaterial(Component, Hit)) : 0;
+}
+
+void ALuminescentObject::SetUpdateTier(const ELuminescentUpdateTier Tier, const float TickInterval)
+{
+	// The tick function accumulates the time between two ticks, so the propagation keeps its pace at any interval
+	if (GetActorTickInterval() != TickInterval)
+		SetActorTickInterval(TickInterval);
+
+	if (Tier == UpdateTier)
+		return;
+
+	UpdateTier = Tier;
+
+	// The material can take a cheaper path away from the gaze, hidden objects keep the quality they had
+	if (Material && Tier != ELuminescentUpdateTier::Hidden)
+		Material->SetScalarParameterValue(TEXT("GlowQuality"), Tier == ELuminescentUpdateTier::Full ? 1.f : Tier == ELuminescentUpdateTier::Reduced ? 0.5f : 0.f);
+
+	if (Tier != ELuminescentUpdateTier::Hidden && PointsDirty && PointBuffer)
+	{
+		// Don't wait for the next tick to show the up to date glow
+		SendPointsToShader();
+		PointsDirty = false;
+	}
+}
+
+int32 ALuminescentObject::FindNearestLocalBakedSource(const FVector& LocalPoint) const
+{
+	if (!bUseBakedGeodesics)
+		return INDEX_NONE;
+
+	const int32 NumSources = FMath::Min(ConcernedVertices.Num(), LuminescentGeodesic::MaxSources);
+
+	int32 NearestSource = INDEX_NONE;
+	double NearestDistanceSquared = FMath::Square(GeodesicSnapDistance);
+
+	for (int32 i = 0; i < NumSources; i++)
+	{
+		const double DistanceSquared = FVector::DistSquared(LocalPoint, ConcernedVertices[i]);
+		if (DistanceSquared <= NearestDistanceSquared)
+		{
+			NearestDistanceSquared = DistanceSquared;
+			NearestSource = i;
+		}
+	}
+
+	return NearestSource;
 }
 
 void ALuminescentObject::ProcessPropagation(FPropagationPointStatus& Point, const float DeltaTime) const
 {
+	const FGlowPropagationProfile& Profile = GetProfile(Point.ProfileIndex);
+	const float TotalTime = Profile.GetTotalPropagationTime();
+
 	Point.PropagationTime += DeltaTime;
 
-	const float TimeRate = Point.PropagationTime / TotalPropagationTime;
-	Point.TimeToSend = UKismetMathLibrary::Ease(0, TotalPropagationTime, TimeRate, EEasingFunc::EaseOut, 3);
+	const float TimeRate = Point.PropagationTime / TotalTime;
+	Point.TimeToSend = TotalTime * PropagationTable.Evaluate(TimeRate);
 
-	// Hacky fix to the long "pause" at the end due to the values very slowly reaching the max
-	// This "interrupts" the fade and jumps straight to the end, ignoring the very subtle changes
-	if (Point.TimeToSend >= TotalPropagationTime * .99f)
+	// Ends with the curve, whatever its shape, so the front never jumps to its last value
+	if (TimeRate >= 1.f)
 	{
-		Point.PropagationTime = Point.TimeToSend;
-		Point.PropagationEndTime = Point.TimeToSend;
+		Point.PropagationTime = TotalTime;
+		Point.PropagationEndTime = TotalTime;
 
-		if (FadeOutDelay > 0.f)
+		if (Profile.FadeOutDelay > 0.f)
 		{
 			// A fade out timer is necessary, so set up an unreal timer
-			Point.FadeOutTimer = FadeOutDelay;
+			Point.FadeOutTimer = Profile.FadeOutDelay;
 			Point.Stage = EPropagationStage::WaitingForFadeOut;
 		}
 		else
@@ -242,12 +590,15 @@ void ALuminescentObject::ProcessPropagation(FPropagationPointStatus& Point, cons
 
 void ALuminescentObject::ProcessFadeOut(FPropagationPointStatus& Point, const float DeltaTime) const
 {
+	const FGlowPropagationProfile& Profile = GetProfile(Point.ProfileIndex);
+	const float TotalTime = Profile.GetTotalPropagationTime();
+
 	// The fade out is done by simply doing the propagation in reverse order
 	Point.PropagationTime += DeltaTime;
 	
-	Point.FadeOutIntensity = FMath::Clamp( (Point.PropagationTime - TotalPropagationTime) / FadeOutDuration, 0, 1);
+	Point.FadeOutIntensity = FadeOutTable.Evaluate((Point.PropagationTime - TotalTime) / Profile.FadeOutDuration);
 
-	if (Point.PropagationTime >= TotalPropagationTime + FadeOutDuration)
+	if (Point.PropagationTime >= TotalTime + Profile.FadeOutDuration)
 	{
 		Point.PropagationTime = 0.0f;
 		Point.FadeOutIntensity = 0.0f;
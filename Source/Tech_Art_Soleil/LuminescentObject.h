@@ -3,13 +3,21 @@
 #pragma once
 
 #include <array>
-#include <functional>
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "GlowCurveTable.h"
+#include "GlowPointBuffer.h"
+#include "GlowProfileSet.h"
+#include "GlowWavefrontSubsystem.h"
+#include "LuminescentSignificanceSubsystem.h"
+#include "PropagationEvent.h"
 #include "Kismet/KismetRenderingLibrary.h"
 #include "LuminescentObject.generated.h"
 
+class UGlowOcclusionSubsystem;
+class UGlowPointAtlasSubsystem;
+
 UCLASS()
 class TECH_ART_SOLEIL_API ALuminescentObject : public AActor
 {
@@ -33,8 +41,8 @@ private:
 		// Propagation stage
 		EPropagationStage Stage = EPropagationStage::Inactive;
 
-		// Where the hit point was
-		FVector HitPoint;
+		// Where the hit point was, in the mesh local space so the glow follows the mesh when it moves
+		FVector LocalHitPoint;
 
 		// Elapsed time during the propagation
 		float PropagationTime = 0.f;
@@ -43,6 +51,15 @@ private:
 		float FadeOutTimer;
 		float FadeOutIntensity;
 		float PropagationDistance;
+
+		// Profile the point propagates with, 0 for the own values of the actor
+		uint8 ProfileIndex = 0;
+
+		// Baked geodesic source the propagation starts from, INDEX_NONE to use the straight-line distance
+		int32 SourceIndex = INDEX_NONE;
+
+		// Changes every time the slot starts a point, so events scheduled for a previous point are ignored
+		uint32 Serial = 0;
 	};
 	
 public:	
@@ -50,6 +67,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:	
 	virtual void Tick(float DeltaTime) override;
@@ -57,6 +75,19 @@ public:
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	// Starts the propagation and its chain on the server and every client, each of them simulates it locally
+	// The start point of the event is in the mesh local space, so every machine finds it wherever the mesh has moved to
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastStartPropagation(const FPropagationEvent& Event);
+
+	// Starts a propagation from a point on the mesh, shared with every client when called on the server
+	void StartPropagation(const FVector& BodyPoint, const float MaxRange, uint8 ProfileIndex = 0);
+
+	const FGlowPropagationProfile& GetProfile(uint8 ProfileIndex) const;
+
+	// Profile of the surface of a hit, 0 when the profile set has none for it
+	uint8 FindProfileIndex(const UPrimitiveComponent* Component, const FHitResult* Hit = nullptr) const;
+
 	static constexpr size_t MaxNumberPropagationPoints = 10;
 	
 	UPROPERTY(BlueprintReadWrite)
@@ -92,19 +123,66 @@ public:
 	UPROPERTY(EditAnywhere)
 	float FadeOutDuration = 1.f;
 
-	UPROPERTY(BlueprintReadWrite)
+	// Profiles of the surfaces that don't propagate with the values above, keyed by physical material
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UGlowProfileSet> ProfileSet = nullptr;
+
+	// Shape of the propagation over time, from 0 to 1 in time and in value, a cubic ease out if not set
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UCurveFloat> PropagationCurve = nullptr;
+
+	// Shape of the fade out over time, from 0 to 1 in time and in value, linear if not set
+	UPROPERTY(EditAnywhere)
+	TObjectPtr<UCurveFloat> FadeOutCurve = nullptr;
+
+	// Source points of the baked surface distances, in the mesh local space
+	// The order matches the UV channels written by the geodesic bake commandlet
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TArray<FVector> ConcernedVertices;
 
+	// Use the surface distances baked into the mesh instead of the straight-line distance to the hit
+	UPROPERTY(EditAnywhere)
+	bool bUseBakedGeodesics = false;
+
+	// How far from a baked source a hit can be to start from it, in the mesh local space
+	// Hits further than this fall back to the straight-line distance
+	UPROPERTY(EditAnywhere)
+	float GeodesicSnapDistance = 50.f;
+
+	ELuminescentUpdateTier GetUpdateTier() const { return UpdateTier; }
+
+	// Changes how often the propagation advances, set by the significance subsystem
+	void SetUpdateTier(ELuminescentUpdateTier Tier, float TickInterval);
+
+	// Adds a chained point, ElapsedTime after the wave left the point, and carries the chain on to the next neighbours
+	void AddPropagationPoint(const FVector& Point, const float MaxRange, const int32 ChainDepth, const TSharedRef<FGlowChainVisits>& Visits, float ElapsedTime);
+
+	// Ends the wait before the fade out of a point, called by the wavefront subsystem
+	void StartFadeOut(size_t Slot, uint32 Serial);
+
 private:
+	// Creates the material instance and the textures it reads, only when the glow is drawn
+	void SetupMaterial();
 	void SetupRenderTarget();
 	void SendPointsToShader();
-	void SendTimesToShader();
-	void SendToShader(UTextureRenderTarget2D* Texture, const std::function<FLinearColor(const FPropagationPointStatus&)>& Lambda);
 
-	void AddPropagationPoint(const FVector& Point, const float MaxRange);
+	// Adds a propagation point to every luminescent object in range the chain hasn't reached yet, up to the scalability chain depth
+	void ChainToNeighbours(const FVector& Point, const float MaxRange, const int32 Depth, const TSharedRef<FGlowChainVisits>& Visits);
 	
-	void TryStartPropagation(const FVector& StartPoint, const float MaxRange);
-	void SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange) const;
+	void TryStartPropagation(const FVector& StartPoint, const float MaxRange, uint8 ProfileIndex = 0, float ElapsedTime = 0.f);
+	void SetupPropagationPoint(const FVector& StartPoint, FPropagationPointStatus& Point, const float MaxRange, uint8 ProfileIndex) const;
+
+	// Time a chained propagation takes to reach the mesh from a point
+	float GetArrivalDelay(const FVector& Point) const;
+
+	// Resumes ticking, the object stops by itself once none of its points moves
+	void WakeUp();
+
+	bool IsIgnoringCollision() const;
+	void IgnoreCollisions();
+
+	// Index of the baked source closest to a point in the mesh local space, INDEX_NONE if none is close enough
+	int32 FindNearestLocalBakedSource(const FVector& LocalPoint) const;
 
 	void ProcessPropagation(FPropagationPointStatus& Point, float DeltaTime) const;
 	void ProcessFadeOut(FPropagationPointStatus& Point, float DeltaTime) const;
@@ -113,19 +191,34 @@ private:
 	std::array<FPropagationPointStatus, MaxNumberPropagationPoints> PropagationPoints = {};
 
 	// Texture holding the points coordinates, this is sent to the shader
+	// Shared by every object through the point atlas, the points of this one are on the AtlasRow row
 	UPROPERTY()
 	UTextureRenderTarget2D* PointsTexture = nullptr;
 
-	// Texture holding the time of each point, this is sent to the shader
+	// Texture holding the time of each point, this is sent to the shader, laid out as the points one
 	UPROPERTY()
 	UTextureRenderTarget2D* TimesTexture = nullptr;
 
-	// Canvas to draw to the texture
+	// Texture holding both curves, this is sent to the shader
 	UPROPERTY()
-	UCanvas* PointsCanvas = nullptr;
+	UTexture2D* CurvesTexture = nullptr;
 
-	UPROPERTY()
-	UCanvas* TimesCanvas = nullptr;
+	// The values set on the actor, as a profile
+	FGlowPropagationProfile OwnProfile;
+
+	// Curves baked at load, evaluated by the propagation and the fade out
+	FGlowCurveTable PropagationTable;
+	FGlowCurveTable FadeOutTable;
+
+	// Hands the points over to the render thread, which uploads them to the textures
+	TSharedPtr<FGlowPointBuffer, ESPMode::ThreadSafe> PointBuffer;
+
+	// Row of the point atlas the points are uploaded to, INDEX_NONE when the object owns its textures
+	int32 AtlasRow = INDEX_NONE;
+
+	// Whether the material reads the points relative to the mesh, advertised by its LocalSpacePoints parameter
+	// They are sent in world space otherwise, and only follow the mesh while they propagate
+	bool bLocalSpacePoints = false;
 
 	// The total time needed to finish the propagation, based on the distance and speed
 	float TotalPropagationTime = 0.f;
@@ -133,5 +226,23 @@ private:
 	// Time ratio to modify the delta time when fading out in order to make it slower or faster
 	float FadeOutTimeRatio = 1.f;
 
-	bool IgnoreCollision = false;
+	// Hits are ignored until then, in world seconds
+	double IgnoreCollisionEndTime = 0.;
+
+	// World time the points last advanced to
+	double LastAdvanceTime = 0.;
+
+	UPROPERTY()
+	TObjectPtr<UGlowWavefrontSubsystem> Wavefront = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UGlowPointAtlasSubsystem> PointAtlas = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<UGlowOcclusionSubsystem> Occlusion = nullptr;
+
+	ELuminescentUpdateTier UpdateTier = ELuminescentUpdateTier::Full;
+
+	// The points changed while hidden and haven't been uploaded yet
+	bool PointsDirty = false;
 };
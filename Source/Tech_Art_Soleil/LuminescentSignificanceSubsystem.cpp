@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LuminescentSignificanceSubsystem.h"
+
+#include "GlowScalability.h"
+#include "LuminescentObject.h"
+#include "Tech_Art_Soleil.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Objects at full rate"), STAT_FullRateObjects, STATGROUP_Bioluminescence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Objects at reduced rate"), STAT_ReducedRateObjects, STATGROUP_Bioluminescence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Objects at minimal rate"), STAT_MinimalRateObjects, STATGROUP_Bioluminescence);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hidden objects"), STAT_HiddenObjects, STATGROUP_Bioluminescence);
+
+void ULuminescentSignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// A recorded path stands in for the eye tracker when measuring without a headset
+	if (!RecordedGazePath.IsEmpty())
+		GazeSource = FRecordedGazeSource::LoadFromFile(FPaths::Combine(FPaths::ProjectDir(), RecordedGazePath));
+
+	if (!GazeSource)
+		GazeSource = MakeUnique<FEyeTrackerGazeSource>();
+}
+
+void ULuminescentSignificanceSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// The gaze is also read outside of the pass, by the manager for its points
+	bHasGaze = GazeSource->GetGaze(*GetWorld(), GetWorld()->GetTimeSeconds(), GazeOrigin, GazeDirection);
+	if (bHasGaze)
+		GazeDirection.Normalize();
+
+	if (Objects.Num() == 0)
+		return;
+
+	const APlayerCameraManager* const Camera = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
+	if (!Camera)
+	{
+		// Nothing to measure significance against, leave the tiers as they are
+		return;
+	}
+
+	const FVector ViewLocation = Camera->GetCameraLocation();
+	const float ViewTanHalfFOV = FMath::Tan(FMath::DegreesToRadians(Camera->GetFOVAngle() * 0.5f));
+
+	const int32 NumEvaluations = FMath::Min(ObjectsPerFrame, Objects.Num());
+	for (int32 i = 0; i < NumEvaluations; i++)
+	{
+		NextObjectIndex = NextObjectIndex % Objects.Num();
+		ALuminescentObject* const Object = Objects[NextObjectIndex++];
+
+		const ELuminescentUpdateTier Tier = ComputeTier(*Object, ViewLocation, ViewTanHalfFOV);
+		Object->SetUpdateTier(Tier, GetTierInterval(Tier));
+	}
+
+#if STATS
+	TStaticArray<uint32, 4> NumObjectsPerTier(InPlace, 0u);
+	for (const ALuminescentObject* const Object : Objects)
+		NumObjectsPerTier[static_cast<int32>(Object->GetUpdateTier())]++;
+
+	SET_DWORD_STAT(STAT_FullRateObjects, NumObjectsPerTier[static_cast<int32>(ELuminescentUpdateTier::Full)]);
+	SET_DWORD_STAT(STAT_ReducedRateObjects, NumObjectsPerTier[static_cast<int32>(ELuminescentUpdateTier::Reduced)]);
+	SET_DWORD_STAT(STAT_MinimalRateObjects, NumObjectsPerTier[static_cast<int32>(ELuminescentUpdateTier::Minimal)]);
+	SET_DWORD_STAT(STAT_HiddenObjects, NumObjectsPerTier[static_cast<int32>(ELuminescentUpdateTier::Hidden)]);
+#endif
+}
+
+TStatId ULuminescentSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULuminescentSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void ULuminescentSignificanceSubsystem::RegisterObject(ALuminescentObject* const Object)
+{
+	Objects.AddUnique(Object);
+}
+
+void ULuminescentSignificanceSubsystem::UnregisterObject(ALuminescentObject* const Object)
+{
+	Objects.RemoveSwap(Object);
+}
+
+float ULuminescentSignificanceSubsystem::GetTierInterval(const ELuminescentUpdateTier Tier) const
+{
+	// No tier updates faster than the scalability allows
+	const float MinInterval = GlowScalability::GetUpdateInterval();
+
+	switch (Tier)
+	{
+		case ELuminescentUpdateTier::Full:
+			return MinInterval;
+
+		case ELuminescentUpdateTier::Reduced:
+			return FMath::Max(ReducedRateInterval, MinInterval);
+
+		case ELuminescentUpdateTier::Minimal:
+			return FMath::Max(MinimalRateInterval, MinInterval);
+
+		case ELuminescentUpdateTier::Hidden:
+			return FMath::Max(HiddenRateInterval, MinInterval);
+	}
+
+	return MinInterval;
+}
+
+ELuminescentUpdateTier ULuminescentSignificanceSubsystem::GetGazeTier(
+	const FVector& Location,
+	const ELuminescentUpdateTier CurrentTier
+) const
+{
+	if (!bHasGaze)
+		return ELuminescentUpdateTier::Full;
+
+	const FVector ToLocation = (Location - GazeOrigin).GetSafeNormal();
+	const float Angle = FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(ToLocation | GazeDirection, -1.f, 1.f)));
+
+	// Same as the screen sizes, leaving a tier needs the location to be clearly out of it
+	const auto Threshold = [this, CurrentTier](const float Value, const ELuminescentUpdateTier Tier) -> float
+	{
+		return CurrentTier <= Tier ? Value * (1.f + Hysteresis) : Value;
+	};
+
+	if (Angle <= Threshold(FovealAngle, ELuminescentUpdateTier::Full))
+		return ELuminescentUpdateTier::Full;
+
+	if (Angle <= Threshold(PeripheralAngle, ELuminescentUpdateTier::Reduced))
+		return ELuminescentUpdateTier::Reduced;
+
+	return ELuminescentUpdateTier::Minimal;
+}
+
+bool ULuminescentSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+ELuminescentUpdateTier ULuminescentSignificanceSubsystem::ComputeTier(
+	const ALuminescentObject& Object,
+	const FVector& ViewLocation,
+	const float ViewTanHalfFOV
+) const
+{
+	if (!Object.WasRecentlyRendered(HiddenDelay))
+		return ELuminescentUpdateTier::Hidden;
+
+	const ELuminescentUpdateTier CurrentTier = Object.GetUpdateTier();
+
+	FVector Origin;
+	FVector Extent;
+	Object.GetActorBounds(true, Origin, Extent);
+
+	const float Distance = FVector::Dist(ViewLocation, Origin);
+
+	// Demoting needs the object to be clearly below the threshold, promoting happens as soon as it is above
+	const auto Threshold = [this, CurrentTier](const float Value, const ELuminescentUpdateTier Tier) -> float
+	{
+		return CurrentTier <= Tier ? Value * (1.f - Hysteresis) : Value;
+	};
+
+	// The gaze can only lower the tier the view gives
+	const ELuminescentUpdateTier GazeTier = GetGazeTier(Origin, CurrentTier);
+
+	if (Distance <= FullRateDistance * (CurrentTier == ELuminescentUpdateTier::Full ? 1.f + Hysteresis : 1.f))
+		return GazeTier;
+
+	const float ScreenSize = Extent.Size() / FMath::Max(Distance * ViewTanHalfFOV, UE_KINDA_SMALL_NUMBER);
+
+	if (ScreenSize >= Threshold(FullRateScreenSize, ELuminescentUpdateTier::Full))
+		return GazeTier;
+
+	if (ScreenSize >= Threshold(ReducedRateScreenSize, ELuminescentUpdateTier::Reduced))
+		return FMath::Max(ELuminescentUpdateTier::Reduced, GazeTier);
+
+	return ELuminescentUpdateTier::Minimal;
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GazeSource.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LuminescentSignificanceSubsystem.generated.h"
+
+class ALuminescentObject;
+
+// How often a luminescent object advances its propagation, from most to least significant
+enum class ELuminescentUpdateTier : uint8
+{
+	// Every frame, close to the camera or large on screen
+	Full,
+	// A few times per second, visible but small on screen
+	Reduced,
+	// Rarely, visible but barely covering any pixel
+	Minimal,
+	// Not rendered recently, keeps advancing but doesn't upload anything
+	Hidden
+};
+
+/**
+ * Assigns an update tier to every luminescent object of the world based on its distance to the camera,
+ * its size on screen and when it was last rendered
+ * When the player gaze is known, objects away from it are demoted further, the periphery of the eye can't tell
+ * Objects are evaluated in slices so the cost of the pass doesn't grow with the number of objects
+ */
+UCLASS(config=Game)
+class TECH_ART_SOLEIL_API ULuminescentSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterObject(ALuminescentObject* Object);
+	void UnregisterObject(ALuminescentObject* Object);
+
+	// Tick interval of an object in the given tier, in seconds
+	float GetTierInterval(ELuminescentUpdateTier Tier) const;
+
+	// Most significant tier a location can have given where the player looks, always Full without any gaze
+	ELuminescentUpdateTier GetGazeTier(const FVector& Location, ELuminescentUpdateTier CurrentTier = ELuminescentUpdateTier::Full) const;
+
+	// Objects closer than this always update every frame, so the glow never steps around the player
+	UPROPERTY(config)
+	float FullRateDistance = 2000.f;
+
+	// Screen size (radius over half the view width) above which an object updates every frame
+	UPROPERTY(config)
+	float FullRateScreenSize = 0.08f;
+
+	// Screen size above which an object updates at the reduced rate, below it uses the minimal rate
+	UPROPERTY(config)
+	float ReducedRateScreenSize = 0.015f;
+
+	// Thresholds are lowered by this ratio before demoting an object, so it doesn't flicker between two tiers
+	UPROPERTY(config)
+	float Hysteresis = 0.2f;
+
+	// Time without being rendered after which an object is considered hidden, in seconds
+	UPROPERTY(config)
+	float HiddenDelay = 0.5f;
+
+	UPROPERTY(config)
+	float ReducedRateInterval = 1.f / 15.f;
+
+	UPROPERTY(config)
+	float MinimalRateInterval = 1.f / 5.f;
+
+	UPROPERTY(config)
+	float HiddenRateInterval = 1.f / 2.f;
+
+	// How many objects are evaluated each frame
+	UPROPERTY(config)
+	int32 ObjectsPerFrame = 64;
+
+	// Angle from the gaze under which the full rate is kept, in degrees
+	UPROPERTY(config)
+	float FovealAngle = 15.f;
+
+	// Angle from the gaze beyond which only the minimal rate is used, in degrees
+	UPROPERTY(config)
+	float PeripheralAngle = 35.f;
+
+	// Replays this gaze path instead of the eye tracker, relative to the project directory, see FRecordedGazeSource::LoadFromFile
+	UPROPERTY(config)
+	FString RecordedGazePath;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	ELuminescentUpdateTier ComputeTier(const ALuminescentObject& Object, const FVector& ViewLocation, float ViewTanHalfFOV) const;
+
+	UPROPERTY()
+	TArray<TObjectPtr<ALuminescentObject>> Objects;
+
+	// Next object to evaluate, the pass resumes from there every frame
+	int32 NextObjectIndex = 0;
+
+	TUniquePtr<IGazeSource> GazeSource;
+
+	// Gaze of the current frame, only valid when bHasGaze is set
+	bool bHasGaze = false;
+	FVector GazeOrigin = FVector::ZeroVector;
+	FVector GazeDirection = FVector::ForwardVector;
+};
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PropagationEvent.h"
+
+#include "GlowProfileSet.h"
+#include "Math/Float16.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+bool FPropagationEvent::NetSerialize(FArchive& Ar, UPackageMap* const Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	// Only as many bits as the position needs
+	StartPoint.NetSerialize(Ar, Map, bOutSuccess);
+
+	// The range only drives the size of the glow, three significant digits are plenty
+	// Half floats saturate at 65504, which is further than any glow can be seen
+	FFloat16 QuantizedRange = MaxRange;
+	Ar << QuantizedRange;
+	MaxRange = QuantizedRange;
+
+	uint8 OnWaterBit = bOnWater ? 1 : 0;
+	Ar.SerializeBits(&OnWaterBit, 1);
+	bOnWater = OnWaterBit != 0;
+
+	uint32 Profile = ProfileIndex;
+	Ar.SerializeInt(Profile, UGlowProfileSet::MaxProfiles + 1);
+	ProfileIndex = static_cast<uint8>(Profile);
+
+	return true;
+}
+
+FPropagationEvent FPropagationEvent::Quantize() const
+{
+	// A round trip through the serializer rounds exactly as the network does
+	FPropagationEvent Copy = *this;
+	FBitWriter Writer(128, true);
+	bool bSuccess = false;
+	Copy.NetSerialize(Writer, nullptr, bSuccess);
+
+	FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+	FPropagationEvent Quantized;
+	Quantized.NetSerialize(Reader, nullptr, bSuccess);
+
+	return Quantized;
+}
+
+int64 FPropagationEvent::GetSerializedBits() const
+{
+	// Serializing quantizes the event, so work on a copy
+	FPropagationEvent Copy = *this;
+	FBitWriter Writer(128, true);
+	bool bSuccess = false;
+	Copy.NetSerialize(Writer, nullptr, bSuccess);
+
+	return Writer.GetNumBits();
+}
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "PropagationEvent.generated.h"
+
+/**
+ * Start of a propagation, replicated instead of the propagation points themselves
+ * Every machine simulates the timeline locally from it, so only the start ever goes over the network
+ */
+USTRUCT()
+struct TECH_ART_SOLEIL_API FPropagationEvent
+{
+	GENERATED_BODY()
+
+	FPropagationEvent() = default;
+
+	FPropagationEvent(const FVector& InStartPoint, const float InMaxRange, const bool bInOnWater = false, const uint8 InProfileIndex = 0)
+		: StartPoint(InStartPoint)
+		, MaxRange(InMaxRange)
+		, bOnWater(bInOnWater)
+		, ProfileIndex(InProfileIndex)
+	{
+	}
+
+	// Where the propagation starts, rounded to the centimetre
+	// In the world for the manager, in the local space of the mesh for a luminescent object
+	UPROPERTY()
+	FVector_NetQuantize StartPoint = FVector::ZeroVector;
+
+	// How far the propagation goes, sent as a half float
+	UPROPERTY()
+	float MaxRange = 0.f;
+
+	// Whether the propagation starts on a water body, which ripples from it, sent as a single bit
+	UPROPERTY()
+	bool bOnWater = false;
+
+	// Profile of the surface the propagation starts on, see UGlowProfileSet, sent on as few bits as the sets allow
+	UPROPERTY()
+	uint8 ProfileIndex = 0;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	// Same event as the clients receive it, the server simulates this one so every machine agrees
+	FPropagationEvent Quantize() const;
+
+	// Size of the event once serialized, in bits
+	int64 GetSerializedBits() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FPropagationEvent> : public TStructOpsTypeTraitsBase2<FPropagationEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
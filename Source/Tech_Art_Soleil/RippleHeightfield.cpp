@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RippleHeightfield.h"
+
+#include "Engine/Texture2D.h"
+#include "Math/Float16.h"
+
+FRippleHeightfield::FRippleHeightfield(const float InCellSize)
+	: CellSize(InCellSize)
+{
+	Current.SetNumZeroed(Stride * Stride);
+	Previous.SetNumZeroed(Stride * Stride);
+
+	constexpr int32 NumTiles = NumTilesPerSide * NumTilesPerSide;
+	ActiveTiles.Init(false, NumTiles);
+	SteppedTiles.Init(false, NumTiles);
+	DirtyTiles.Init(false, NumTiles);
+}
+
+UTexture2D* FRippleHeightfield::CreateTexture()
+{
+	UTexture2D* const Texture = UTexture2D::CreateTransient(Resolution, Resolution, PF_R16F);
+	if (!Texture)
+		return nullptr;
+
+	FTexture2DMipMap& Mip = Texture->GetPlatformData()->Mips[0];
+	FMemory::Memzero(Mip.BulkData.Lock(LOCK_READ_WRITE), Resolution * Resolution * sizeof(FFloat16));
+	Mip.BulkData.Unlock();
+
+	// The material derives the normals from neighbouring texels, so keep them smooth
+	Texture->Filter = TF_Bilinear;
+	Texture->AddressX = TA_Clamp;
+	Texture->AddressY = TA_Clamp;
+	Texture->SRGB = false;
+	Texture->UpdateResource();
+
+	return Texture;
+}
+
+FLinearColor FRippleHeightfield::GetWindow() const
+{
+	const float Size = Resolution * CellSize;
+	return FLinearColor(Origin.X, Origin.Y, Size, 1.f / Size);
+}
+
+bool FRippleHeightfield::Recenter(const FVector& Location)
+{
+	if (ActiveTiles.Contains(true) || DirtyTiles.Contains(true))
+		return false;
+
+	// Snapped to whole tiles so the window doesn't move for every step of the player
+	const float TileWorldSize = TileSize * CellSize;
+	const FVector2D NewOrigin(
+		FMath::GridSnap(Location.X, TileWorldSize) - Resolution * CellSize * 0.5f,
+		FMath::GridSnap(Location.Y, TileWorldSize) - Resolution * CellSize * 0.5f
+	);
+
+	if (NewOrigin == Origin)
+		return false;
+
+	Origin = NewOrigin;
+	return true;
+}
+
+void FRippleHeightfield::Disturb(const FVector& Location, const float Strength)
+{
+	constexpr int32 Radius = 2;
+
+	const int32 CenterX = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 CenterY = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+
+	for (int32 Y = FMath::Max(CenterY - Radius, 0); Y <= FMath::Min(CenterY + Radius, Resolution - 1); Y++)
+	{
+		for (int32 X = FMath::Max(CenterX - Radius, 0); X <= FMath::Min(CenterX + Radius, Resolution - 1); X++)
+		{
+			// Smooth bump, a single cell impulse would only make noise at this resolution
+			const float Falloff = 1.f - FMath::Square(FVector2f(X - CenterX, Y - CenterY).Size() / (Radius + 1));
+			if (Falloff <= 0.f)
+				continue;
+
+			Current[GetCellIndex(X, Y)] -= Strength * Falloff;
+			ActiveTiles[GetTileIndex(X / TileSize, Y / TileSize)] = true;
+		}
+	}
+}
+
+void FRippleHeightfield::Advance(const float DeltaTime)
+{
+	if (!ActiveTiles.Contains(true))
+	{
+		PendingTime = 0.f;
+		return;
+	}
+
+	// Never more than a few steps, a long hitch would otherwise stall the frame even more
+	constexpr int32 MaxSteps = 4;
+	PendingTime = FMath::Min(PendingTime + DeltaTime, StepDuration * MaxSteps);
+
+	while (PendingTime >= StepDuration)
+	{
+		Step();
+		PendingTime -= StepDuration;
+	}
+}
+
+void FRippleHeightfield::Step()
+{
+	// Waves can spill out of an active tile, so its neighbours are simulated with it
+	SteppedTiles.Init(false, SteppedTiles.Num());
+	for (TConstSetBitIterator<> It(ActiveTiles); It; ++It)
+	{
+		const int32 TileX = It.GetIndex() % NumTilesPerSide;
+		const int32 TileY = It.GetIndex() / NumTilesPerSide;
+
+		SteppedTiles[It.GetIndex()] = true;
+		if (TileX > 0)
+			SteppedTiles[GetTileIndex(TileX - 1, TileY)] = true;
+		if (TileX < NumTilesPerSide - 1)
+			SteppedTiles[GetTileIndex(TileX + 1, TileY)] = true;
+		if (TileY > 0)
+			SteppedTiles[GetTileIndex(TileX, TileY - 1)] = true;
+		if (TileY < NumTilesPerSide - 1)
+			SteppedTiles[GetTileIndex(TileX, TileY + 1)] = true;
+	}
+
+	for (TConstSetBitIterator<> It(SteppedTiles); It; ++It)
+	{
+		const int32 TileX = It.GetIndex() % NumTilesPerSide;
+		const int32 TileY = It.GetIndex() / NumTilesPerSide;
+
+		const bool bActive = SimulateTile(TileX, TileY) > CalmHeight;
+		ActiveTiles[It.GetIndex()] = bActive;
+		DirtyTiles[It.GetIndex()] = true;
+	}
+
+	// The next heights were written over the previous ones
+	Swap(Current, Previous);
+
+	// Tiles that calmed down are flattened, so the invariant of the inactive tiles holds
+	for (TConstSetBitIterator<> It(SteppedTiles); It; ++It)
+	{
+		if (!ActiveTiles[It.GetIndex()])
+			ClearTile(It.GetIndex() % NumTilesPerSide, It.GetIndex() / NumTilesPerSide);
+	}
+}
+
+float FRippleHeightfield::SimulateTile(const int32 TileX, const int32 TileY)
+{
+	static_assert(TileSize % 4 == 0, "Tiles are simulated four cells at a time");
+
+	const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+	const VectorRegister4Float DampingVector = VectorSetFloat1(Damping);
+	VectorRegister4Float MaxHeight = VectorZeroFloat();
+
+	const float* const Heights = Current.GetData();
+	float* const Next = Previous.GetData();
+
+	for (int32 Y = TileY * TileSize; Y < (TileY + 1) * TileSize; Y++)
+	{
+		for (int32 X = TileX * TileSize; X < (TileX + 1) * TileSize; X += 4)
+		{
+			const int32 Index = GetCellIndex(X, Y);
+
+			// Next = (average of the neighbours * 2 - previous) * damping
+			const VectorRegister4Float Left = VectorLoad(Heights + Index - 1);
+			const VectorRegister4Float Right = VectorLoad(Heights + Index + 1);
+			const VectorRegister4Float Up = VectorLoad(Heights + Index - Stride);
+			const VectorRegister4Float Down = VectorLoad(Heights + Index + Stride);
+			const VectorRegister4Float Last = VectorLoad(Next + Index);
+
+			const VectorRegister4Float Sum = VectorAdd(VectorAdd(Left, Right), VectorAdd(Up, Down));
+			const VectorRegister4Float Height = VectorMultiply(VectorSubtract(VectorMultiply(Sum, Half), Last), DampingVector);
+
+			VectorStore(Height, Next + Index);
+			MaxHeight = VectorMax(MaxHeight, VectorAbs(Height));
+		}
+	}
+
+	float Lanes[4];
+	VectorStore(MaxHeight, Lanes);
+	return FMath::Max(FMath::Max(Lanes[0], Lanes[1]), FMath::Max(Lanes[2], Lanes[3]));
+}
+
+void FRippleHeightfield::ClearTile(const int32 TileX, const int32 TileY)
+{
+	for (int32 Y = TileY * TileSize; Y < (TileY + 1) * TileSize; Y++)
+	{
+		const int32 Index = GetCellIndex(TileX * TileSize, Y);
+		FMemory::Memzero(&Current[Index], TileSize * sizeof(float));
+		FMemory::Memzero(&Previous[Index], TileSize * sizeof(float));
+	}
+}
+
+void FRippleHeightfield::Upload(UTexture2D* const Texture)
+{
+	const int32 NumRegions = DirtyTiles.CountSetBits();
+	if (!Texture || NumRegions == 0)
+		return;
+
+	// Both are freed by the render thread once the upload is done
+	FFloat16* const Texels = new FFloat16[Resolution * Resolution];
+	FUpdateTextureRegion2D* const Regions = new FUpdateTextureRegion2D[NumRegions];
+
+	int32 RegionIndex = 0;
+	for (TConstSetBitIterator<> It(DirtyTiles); It; ++It)
+	{
+		const int32 TileX = It.GetIndex() % NumTilesPerSide;
+		const int32 TileY = It.GetIndex() / NumTilesPerSide;
+
+		for (int32 Y = TileY * TileSize; Y < (TileY + 1) * TileSize; Y++)
+		{
+			for (int32 X = TileX * TileSize; X < (TileX + 1) * TileSize; X++)
+				Texels[Y * Resolution + X] = Current[GetCellIndex(X, Y)];
+		}
+
+		const uint32 RegionX = TileX * TileSize;
+		const uint32 RegionY = TileY * TileSize;
+		Regions[RegionIndex++] = FUpdateTextureRegion2D(RegionX, RegionY, RegionX, RegionY, TileSize, TileSize);
+	}
+
+	DirtyTiles.Init(false, DirtyTiles.Num());
+
+	Texture->UpdateTextureRegions(0, NumRegions, Regions, Resolution * sizeof(FFloat16), sizeof(FFloat16),
+		reinterpret_cast<uint8*>(Texels),
+		[](uint8* const Data, const FUpdateTextureRegion2D* const UploadedRegions) -> void
+		{
+			delete[] reinterpret_cast<FFloat16*>(Data);
+			delete[] UploadedRegions;
+		});
+}
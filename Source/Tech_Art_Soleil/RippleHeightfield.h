@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTexture2D;
+
+/**
+ * Small wave simulation of the water surface around the player, fed by the propagations starting on water
+ *
+ * The window is split in tiles and only the tiles with waves in them, and their neighbours, are simulated
+ * Calm tiles are zero in both buffers, so the edge of an active tile spills into its neighbours naturally
+ * Only the tiles that changed since the last upload are sent to the texture
+ */
+class FRippleHeightfield final
+{
+public:
+	static constexpr int32 TileSize = 16;
+	static constexpr int32 NumTilesPerSide = 8;
+	static constexpr int32 Resolution = TileSize * NumTilesPerSide;
+
+	explicit FRippleHeightfield(float InCellSize);
+
+	// Half float texture of the heights, one texel per cell
+	static UTexture2D* CreateTexture();
+
+	// Lower corner of the window in X and Y, its size, and one over its size, for the material
+	FLinearColor GetWindow() const;
+
+	// Moves the window around a location, only when the water is calm so no wave is cut
+	// Returns whether the window moved
+	bool Recenter(const FVector& Location);
+
+	// Pushes the surface down around a point, ignored outside of the window
+	void Disturb(const FVector& Location, float Strength);
+
+	// Runs as many fixed steps as the time covers
+	void Advance(float DeltaTime);
+
+	// Sends the tiles changed since the last upload, nothing if none did
+	void Upload(UTexture2D* Texture);
+
+	// Ratio of the height kept each step, the waves die out faster when lower
+	float Damping = 0.97f;
+
+	// Duration of one simulation step, in seconds
+	float StepDuration = 1.f / 30.f;
+
+	// Waves lower than this are considered gone
+	float CalmHeight = 0.01f;
+
+private:
+	// The buffers have a border of one cell that always stays at zero, so no neighbour read needs a bound check
+	static constexpr int32 Stride = Resolution + 2;
+
+	static int32 GetCellIndex(const int32 X, const int32 Y) { return (Y + 1) * Stride + X + 1; }
+	static int32 GetTileIndex(const int32 TileX, const int32 TileY) { return TileY * NumTilesPerSide + TileX; }
+
+	void Step();
+
+	// Writes the next heights of the tile over the previous ones, returns the highest wave of the tile
+	float SimulateTile(int32 TileX, int32 TileY);
+	void ClearTile(int32 TileX, int32 TileY);
+
+	float CellSize = 1.f;
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	TArray<float> Current;
+	TArray<float> Previous;
+
+	TBitArray<> ActiveTiles;
+	TBitArray<> SteppedTiles;
+	TBitArray<> DirtyTiles;
+
+	float PendingTime = 0.f;
+};
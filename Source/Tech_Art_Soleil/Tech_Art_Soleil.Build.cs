@@ -9,5 +9,11 @@ public class Tech_Art_Soleil : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "Foliage", "Landscape" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore", "RHI", "HeadMountedDisplay", "EyeTracker", "Water", "Chaos", "PhysicsCore" });
+
+		// Undo support for the editor only conversions
+		if (Target.bBuildEditor)
+			PrivateDependencyModuleNames.Add("UnrealEd");
 	}
 }
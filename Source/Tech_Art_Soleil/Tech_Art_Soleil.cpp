@@ -3,5 +3,7 @@
 #include "Tech_Art_Soleil.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogBioluminescence);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Tech_Art_Soleil, "Tech_Art_Soleil" );
  
\ No newline at end of file
@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogBioluminescence, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Bioluminescence"), STATGROUP_Bioluminescence, STATCAT_Advanced);
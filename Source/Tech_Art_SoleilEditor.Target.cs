@@ -11,5 +11,6 @@ public class Tech_Art_SoleilEditorTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_4;
 		ExtraModuleNames.Add("Tech_Art_Soleil");
+		ExtraModuleNames.Add("Tech_Art_SoleilEditor");
 	}
 }
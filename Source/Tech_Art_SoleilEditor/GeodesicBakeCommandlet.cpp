@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GeodesicBakeCommandlet.h"
+
+#include "LuminescentGeodesic.h"
+#include "LuminescentObject.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/SavePackage.h"
+
+DEFINE_LOG_CATEGORY(LogGeodesicBake);
+
+namespace
+{
+	// Distance written for the vertices not connected to the source, far enough to never glow
+	constexpr float UnreachedDistance = 1.e6f;
+}
+
+UGeodesicBakeCommandlet::UGeodesicBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGeodesicBakeCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	const FString* const Maps = ParamsMap.Find(TEXT("Maps"));
+	if (!Maps)
+	{
+		UE_LOG(LogGeodesicBake, Error, TEXT("Missing -Maps=/Game/Map1+/Game/Map2 argument"));
+		return 1;
+	}
+
+	TArray<FString> MapPaths;
+	Maps->ParseIntoArray(MapPaths, TEXT("+"));
+
+	// Meshes are shared between actors, so gather everything first and bake each mesh once
+	TMap<UStaticMesh*, TArray<FVector>> MeshSources;
+	for (const FString& MapPath : MapPaths)
+		GatherSources(MapPath, MeshSources);
+
+	int32 NumFailed = 0;
+	for (const TPair<UStaticMesh*, TArray<FVector>>& Pair : MeshSources)
+	{
+		if (!BakeMesh(Pair.Key, Pair.Value) || !SavePackage(Pair.Key))
+			NumFailed++;
+	}
+
+	UE_LOG(LogGeodesicBake, Display, TEXT("Baked %d meshes, %d failed"), MeshSources.Num() - NumFailed, NumFailed);
+	return NumFailed > 0 ? 1 : 0;
+}
+
+void UGeodesicBakeCommandlet::GatherSources(const FString& MapPath, TMap<UStaticMesh*, TArray<FVector>>& MeshSources) const
+{
+	UPackage* const Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+	const UWorld* const World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World || !World->PersistentLevel)
+	{
+		UE_LOG(LogGeodesicBake, Error, TEXT("Could not load map %s"), *MapPath);
+		return;
+	}
+
+	for (const AActor* const Actor : World->PersistentLevel->Actors)
+	{
+		const ALuminescentObject* const LuminescentObject = Cast<ALuminescentObject>(Actor);
+		if (!LuminescentObject || !LuminescentObject->bUseBakedGeodesics || LuminescentObject->ConcernedVertices.IsEmpty())
+			continue;
+
+		const UStaticMeshComponent* const MeshComponent = LuminescentObject->GetComponentByClass<UStaticMeshComponent>();
+		UStaticMesh* const Mesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+		if (!Mesh)
+			continue;
+
+		const TArray<FVector>* const Existing = MeshSources.Find(Mesh);
+		if (!Existing)
+		{
+			MeshSources.Add(Mesh, LuminescentObject->ConcernedVertices);
+		}
+		else if (*Existing != LuminescentObject->ConcernedVertices)
+		{
+			// Only one set of sources can live in the mesh, the first one found wins
+			UE_LOG(LogGeodesicBake, Warning, TEXT("%s uses %s with different sources than another actor, its sources are ignored"),
+				*LuminescentObject->GetName(), *Mesh->GetName());
+		}
+	}
+}
+
+bool UGeodesicBakeCommandlet::BakeMesh(UStaticMesh* const Mesh, const TArray<FVector>& Sources) const
+{
+	FMeshDescription* const MeshDescription = Mesh->GetMeshDescription(0);
+	if (!MeshDescription)
+	{
+		UE_LOG(LogGeodesicBake, Error, TEXT("%s has no mesh description"), *Mesh->GetName());
+		return false;
+	}
+
+	if (Mesh->GetLightMapCoordinateIndex() >= LuminescentGeodesic::FirstUVChannel)
+	{
+		UE_LOG(LogGeodesicBake, Error, TEXT("%s stores its lightmap in UV channel %d, which is reserved for the baked distances"),
+			*Mesh->GetName(), Mesh->GetLightMapCoordinateIndex());
+		return false;
+	}
+
+	if (Sources.Num() > LuminescentGeodesic::MaxSources)
+	{
+		UE_LOG(LogGeodesicBake, Warning, TEXT("%s has %d sources, only the first %d are baked"),
+			*Mesh->GetName(), Sources.Num(), LuminescentGeodesic::MaxSources);
+	}
+
+	const int32 NumSources = FMath::Min(Sources.Num(), LuminescentGeodesic::MaxSources);
+
+	FStaticMeshAttributes Attributes(*MeshDescription);
+	TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+
+	const int32 NumChannels = LuminescentGeodesic::GetUVChannel(NumSources - 1) + 1;
+	if (UVs.GetNumChannels() < NumChannels)
+		UVs.SetNumChannels(NumChannels);
+
+	TArray<float> Distances;
+	for (int32 SourceIndex = 0; SourceIndex < NumSources; SourceIndex++)
+	{
+		ComputeSurfaceDistances(*MeshDescription, FVector3f(Sources[SourceIndex]), Distances);
+
+		const int32 Channel = LuminescentGeodesic::GetUVChannel(SourceIndex);
+		const int32 Component = LuminescentGeodesic::GetUVComponent(SourceIndex);
+
+		// Vertices are welded by position, so every instance of a vertex gets the same distance across UV seams
+		for (const FVertexID VertexID : MeshDescription->Vertices().GetElementIDs())
+		{
+			for (const FVertexInstanceID VertexInstanceID : MeshDescription->GetVertexVertexInstanceIDs(VertexID))
+			{
+				FVector2f UV = UVs.Get(VertexInstanceID, Channel);
+				UV[Component] = Distances[VertexID.GetValue()];
+				UVs.Set(VertexInstanceID, Channel, UV);
+			}
+		}
+	}
+
+	// Half precision UVs would round the distances far from the source
+	Mesh->GetSourceModel(0).BuildSettings.bUseFullPrecisionUVs = true;
+
+	Mesh->CommitMeshDescription(0);
+	Mesh->Build();
+	Mesh->MarkPackageDirty();
+
+	UE_LOG(LogGeodesicBake, Display, TEXT("Baked %d sources into %s"), NumSources, *Mesh->GetName());
+	return true;
+}
+
+void UGeodesicBakeCommandlet::ComputeSurfaceDistances(const FMeshDescription& MeshDescription, const FVector3f& Source, TArray<float>& Distances)
+{
+	// Walking the edges overestimates the true geodesic distance a little on coarse meshes, which is fine for the glow
+	TVertexAttributesConstRef<FVector3f> Positions = MeshDescription.GetVertexPositions();
+
+	Distances.Init(UnreachedDistance, MeshDescription.Vertices().GetArraySize());
+
+	// Start from the vertex closest to the source
+	FVertexID StartVertex = INDEX_NONE;
+	float StartDistanceSquared = TNumericLimits<float>::Max();
+	for (const FVertexID VertexID : MeshDescription.Vertices().GetElementIDs())
+	{
+		const float DistanceSquared = FVector3f::DistSquared(Positions[VertexID], Source);
+		if (DistanceSquared < StartDistanceSquared)
+		{
+			StartDistanceSquared = DistanceSquared;
+			StartVertex = VertexID;
+		}
+	}
+
+	if (StartVertex == INDEX_NONE)
+		return;
+
+	using FQueueEntry = TPair<float, FVertexID>;
+	const auto Predicate = [](const FQueueEntry& A, const FQueueEntry& B) -> bool { return A.Key < B.Key; };
+
+	TArray<FQueueEntry> Queue;
+	Distances[StartVertex.GetValue()] = FMath::Sqrt(StartDistanceSquared);
+	Queue.HeapPush(FQueueEntry(Distances[StartVertex.GetValue()], StartVertex), Predicate);
+
+	while (!Queue.IsEmpty())
+	{
+		FQueueEntry Entry;
+		Queue.HeapPop(Entry, Predicate, EAllowShrinking::No);
+
+		const FVertexID VertexID = Entry.Value;
+		if (Entry.Key > Distances[VertexID.GetValue()])
+		{
+			// Stale entry, the vertex was already reached by a shorter path
+			continue;
+		}
+
+		for (const FEdgeID EdgeID : MeshDescription.GetVertexConnectedEdgeIDs(VertexID))
+		{
+			const FVertexID EdgeStart = MeshDescription.GetEdgeVertex(EdgeID, 0);
+			const FVertexID Neighbour = EdgeStart == VertexID ? MeshDescription.GetEdgeVertex(EdgeID, 1) : EdgeStart;
+
+			const float Distance = Entry.Key + FVector3f::Dist(Positions[VertexID], Positions[Neighbour]);
+			if (Distance < Distances[Neighbour.GetValue()])
+			{
+				Distances[Neighbour.GetValue()] = Distance;
+				Queue.HeapPush(FQueueEntry(Distance, Neighbour), Predicate);
+			}
+		}
+	}
+}
+
+bool UGeodesicBakeCommandlet::SavePackage(UStaticMesh* const Mesh)
+{
+	UPackage* const Package = Mesh->GetOutermost();
+	const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+
+	if (!UPackage::SavePackage(Package, Mesh, *Filename, SaveArgs))
+	{
+		UE_LOG(LogGeodesicBake, Error, TEXT("Could not save %s"), *Filename);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GeodesicBakeCommandlet.generated.h"
+
+struct FMeshDescription;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogGeodesicBake, Log, All);
+
+/**
+ * Bakes the surface distance from each ALuminescentObject source (ConcernedVertices) into the UV channels of its mesh,
+ * so the material can follow the surface instead of using the straight-line distance to the hit
+ *
+ * Usage: UnrealEditor-Cmd.exe Tech_Art_Soleil.uproject -run=GeodesicBake -Maps=/Game/Content/Maps/TestMap+/Game/Content/Maps/L_Sarah
+ */
+UCLASS()
+class UGeodesicBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGeodesicBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Gathers the sources of every luminescent object in the map, keyed by the mesh they will be baked into
+	void GatherSources(const FString& MapPath, TMap<UStaticMesh*, TArray<FVector>>& MeshSources) const;
+
+	// Writes the distances to every source into the mesh UV channels, returns false if the mesh can't be baked
+	bool BakeMesh(UStaticMesh* Mesh, const TArray<FVector>& Sources) const;
+
+	// Dijkstra over the mesh edges, from the vertex closest to the source
+	static void ComputeSurfaceDistances(const FMeshDescription& MeshDescription, const FVector3f& Source, TArray<float>& Distances);
+
+	static bool SavePackage(UStaticMesh* Mesh);
+};
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowManifestCommandlet.h"
+
+#include "ABioluminescentManager.h"
+#include "FileHelpers.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY(LogGlowManifest);
+
+UGlowManifestCommandlet::UGlowManifestCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGlowManifestCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	const FString* const Maps = ParamsMap.Find(TEXT("Maps"));
+	if (!Maps)
+	{
+		UE_LOG(LogGlowManifest, Error, TEXT("Missing -Maps=/Game/Map1+/Game/Map2 argument"));
+		return 1;
+	}
+
+	TArray<FString> MapPaths;
+	Maps->ParseIntoArray(MapPaths, TEXT("+"));
+
+	int32 NumFailed = 0;
+	for (const FString& MapPath : MapPaths)
+	{
+		if (!BuildMap(MapPath))
+			NumFailed++;
+	}
+
+	UE_LOG(LogGlowManifest, Display, TEXT("Built the manifests of %d maps, %d failed"), MapPaths.Num() - NumFailed, NumFailed);
+	return NumFailed > 0 ? 1 : 0;
+}
+
+bool UGlowManifestCommandlet::BuildMap(const FString& MapPath)
+{
+	UPackage* const Package = LoadPackage(nullptr, *MapPath, LOAD_None);
+	const UWorld* const World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World || !World->PersistentLevel)
+	{
+		UE_LOG(LogGlowManifest, Error, TEXT("Could not load map %s"), *MapPath);
+		return false;
+	}
+
+	// A manager saved in its own package with one file per actor, or in the map itself
+	TArray<UPackage*> PackagesToSave;
+	for (AActor* const Actor : World->PersistentLevel->Actors)
+	{
+		ABioluminescentManager* const Manager = Cast<ABioluminescentManager>(Actor);
+		if (!Manager)
+			continue;
+
+		Manager->BuildManifest();
+		PackagesToSave.AddUnique(Manager->GetPackage());
+
+		UE_LOG(LogGlowManifest, Display, TEXT("%s: %d surfaces, %d query only components, %d water bodies, %d glow mask volumes"), *Manager->GetName(),
+			Manager->ManifestSurfaces.Num(), Manager->ManifestQueryOnly.Num(), Manager->ManifestWaterBodies.Num(), Manager->ManifestGlowMaskVolumes.Num());
+	}
+
+	if (PackagesToSave.IsEmpty())
+	{
+		UE_LOG(LogGlowManifest, Warning, TEXT("%s has no bioluminescent manager"), *MapPath);
+		return true;
+	}
+
+	if (!UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, false))
+	{
+		UE_LOG(LogGlowManifest, Error, TEXT("Could not save the managers of %s"), *MapPath);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GlowManifestCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogGlowManifest, Log, All);
+
+/**
+ * Records in each ABioluminescentManager the components of its level whose materials read the glow parameters,
+ * so the game loads them directly instead of scanning the world, run it before cooking
+ *
+ * Usage: UnrealEditor-Cmd.exe Tech_Art_Soleil.uproject -run=GlowManifest -Maps=/Game/Content/Maps/TestMap+/Game/Content/Maps/L_Sarah
+ */
+UCLASS()
+class UGlowManifestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGlowManifestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	// Builds the manifest of every manager of the map and saves them, returns false if any can't be saved
+	static bool BuildMap(const FString& MapPath);
+};
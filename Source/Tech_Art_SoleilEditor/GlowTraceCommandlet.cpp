@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlowTraceCommandlet.h"
+
+#include "Misc/FileHelper.h"
+#include "Trace/Analysis.h"
+#include "Trace/Analyzer.h"
+#include "Trace/DataStream.h"
+
+DEFINE_LOG_CATEGORY(LogGlowTrace);
+
+namespace
+{
+	// Same order as the enums of GlowTrace.h and of the propagation stages
+	const TCHAR* const HitSourceNames[] = { TEXT("Collision"), TEXT("Player"), TEXT("Water"), TEXT("Hand"), TEXT("Chain") };
+	const TCHAR* const DropReasonNames[] = { TEXT("Ignored"), TEXT("PoolFull") };
+	const TCHAR* const StageNames[] = { TEXT("Inactive"), TEXT("Active"), TEXT("WaitingForFadeOut"), TEXT("FadeOut") };
+
+	template<size_t N>
+	const TCHAR* GetName(const TCHAR* const (&Names)[N], const uint8 Value)
+	{
+		return Value < N ? Names[Value] : TEXT("Unknown");
+	}
+
+	/**
+	 * Turns the events of the Bioluminescence logger into timeline rows and per actor counts
+	 */
+	class FGlowTraceAnalyzer final : public UE::Trace::IAnalyzer
+	{
+	public:
+		struct FRow final
+		{
+			double Time = 0.;
+			uint32 Owner = 0;
+			const TCHAR* Event = nullptr;
+			int32 Slot = INDEX_NONE;
+			FString Detail;
+		};
+
+		struct FOwnerSummary final
+		{
+			uint32 NumHits = 0;
+			uint32 NumIgnored = 0;
+			uint32 NumPoolFull = 0;
+			uint32 NumStarts = 0;
+			uint32 NumEvictions = 0;
+			uint32 NumUploads = 0;
+			uint32 MaxLivePoints = 0;
+		};
+
+		TArray<FRow> Rows;
+		TMap<uint32, FString> OwnerNames;
+		TMap<uint32, FOwnerSummary> Summaries;
+
+		double From = 0.;
+		double To = TNumericLimits<double>::Max();
+
+		virtual void OnAnalysisBegin(const FOnAnalysisContext& Context) override
+		{
+			FInterfaceBuilder& Builder = Context.InterfaceBuilder;
+			Builder.RouteEvent(RouteId_OwnerInfo, "Bioluminescence", "OwnerInfo");
+			Builder.RouteEvent(RouteId_Hit, "Bioluminescence", "Hit");
+			Builder.RouteEvent(RouteId_HitDropped, "Bioluminescence", "HitDropped");
+			Builder.RouteEvent(RouteId_PointStart, "Bioluminescence", "PointStart");
+			Builder.RouteEvent(RouteId_StageChange, "Bioluminescence", "StageChange");
+			Builder.RouteEvent(RouteId_PointEvict, "Bioluminescence", "PointEvict");
+			Builder.RouteEvent(RouteId_Upload, "Bioluminescence", "Upload");
+		}
+
+		virtual bool OnEvent(const uint16 RouteId, EStyle, const FOnEventContext& Context) override
+		{
+			const FEventData& EventData = Context.EventData;
+
+			if (RouteId == RouteId_OwnerInfo)
+			{
+				FString Name;
+				EventData.GetString("Name", Name);
+				OwnerNames.Add(EventData.GetValue<uint32>("Id"), MoveTemp(Name));
+				return true;
+			}
+
+			const uint32 Owner = EventData.GetValue<uint32>("Owner");
+			FOwnerSummary& Summary = Summaries.FindOrAdd(Owner);
+
+			const double Time = Context.EventTime.AsSeconds(EventData.GetValue<uint64>("Cycle"));
+			const bool bInRange = Time >= From && Time <= To;
+
+			FRow Row;
+			Row.Time = Time;
+			Row.Owner = Owner;
+
+			switch (RouteId)
+			{
+				case RouteId_Hit:
+					Summary.NumHits++;
+					Row.Event = TEXT("Hit");
+					Row.Detail = GetName(HitSourceNames, EventData.GetValue<uint8>("Source"));
+					break;
+
+				case RouteId_HitDropped:
+				{
+					const uint8 Reason = EventData.GetValue<uint8>("Reason");
+					if (Reason == 0)
+						Summary.NumIgnored++;
+					else
+						Summary.NumPoolFull++;
+
+					Row.Event = TEXT("HitDropped");
+					Row.Detail = GetName(DropReasonNames, Reason);
+					break;
+				}
+
+				case RouteId_PointStart:
+					Summary.NumStarts++;
+					Row.Event = TEXT("PointStart");
+					Row.Slot = EventData.GetValue<uint8>("Slot");
+					Row.Detail = FString::Printf(TEXT("Profile %d"), EventData.GetValue<uint8>("Profile"));
+					break;
+
+				case RouteId_StageChange:
+					Row.Event = TEXT("StageChange");
+					Row.Slot = EventData.GetValue<uint8>("Slot");
+					Row.Detail = GetName(StageNames, EventData.GetValue<uint8>("Stage"));
+					break;
+
+				case RouteId_PointEvict:
+					Summary.NumEvictions++;
+					Row.Event = TEXT("PointEvict");
+					Row.Slot = EventData.GetValue<uint8>("Slot");
+					Row.Detail = FString::Printf(TEXT("Into %d"), EventData.GetValue<uint8>("IntoSlot"));
+					break;
+
+				case RouteId_Upload:
+				{
+					const uint16 NumPoints = EventData.GetValue<uint16>("NumPoints");
+					Summary.NumUploads++;
+					Summary.MaxLivePoints = FMath::Max<uint32>(Summary.MaxLivePoints, NumPoints);
+					Row.Event = TEXT("Upload");
+					Row.Detail = FString::Printf(TEXT("%d points"), NumPoints);
+					break;
+				}
+
+				default:
+					return true;
+			}
+
+			if (bInRange)
+				Rows.Add(MoveTemp(Row));
+
+			return true;
+		}
+
+		const FString& GetOwnerName(const uint32 Owner) const
+		{
+			static const FString Unknown = TEXT("Unknown");
+			const FString* const Name = OwnerNames.Find(Owner);
+			return Name ? *Name : Unknown;
+		}
+
+	private:
+		enum : uint16
+		{
+			RouteId_OwnerInfo,
+			RouteId_Hit,
+			RouteId_HitDropped,
+			RouteId_PointStart,
+			RouteId_StageChange,
+			RouteId_PointEvict,
+			RouteId_Upload
+		};
+	};
+}
+
+UGlowTraceCommandlet::UGlowTraceCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGlowTraceCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamsMap;
+	ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+	const FString* const TracePath = ParamsMap.Find(TEXT("Trace"));
+	if (!TracePath)
+	{
+		UE_LOG(LogGlowTrace, Error, TEXT("Missing -Trace=Path/To/Session.utrace argument"));
+		return 1;
+	}
+
+	UE::Trace::FFileDataStream DataStream;
+	if (!DataStream.Open(**TracePath))
+	{
+		UE_LOG(LogGlowTrace, Error, TEXT("Could not open the trace %s"), **TracePath);
+		return 1;
+	}
+
+	FGlowTraceAnalyzer Analyzer;
+	if (const FString* const From = ParamsMap.Find(TEXT("From")))
+		Analyzer.From = FCString::Atod(**From);
+	if (const FString* const To = ParamsMap.Find(TEXT("To")))
+		Analyzer.To = FCString::Atod(**To);
+
+	UE::Trace::FAnalysisContext Context;
+	Context.AddAnalyzer(Analyzer);
+	Context.Process(DataStream).Wait();
+
+	// Events of different threads arrive in their own order
+	Analyzer.Rows.StableSort([](const FGlowTraceAnalyzer::FRow& A, const FGlowTraceAnalyzer::FRow& B) -> bool
+	{
+		return A.Time < B.Time;
+	});
+
+	const FString* const CsvPath = ParamsMap.Find(TEXT("Csv"));
+
+	TArray<FString> Lines;
+	Lines.Reserve(Analyzer.Rows.Num() + 1);
+	Lines.Add(TEXT("Time,Owner,Event,Slot,Detail"));
+
+	for (const FGlowTraceAnalyzer::FRow& Row : Analyzer.Rows)
+	{
+		const FString Slot = Row.Slot == INDEX_NONE ? FString() : FString::FromInt(Row.Slot);
+		Lines.Add(FString::Printf(TEXT("%.6f,%s,%s,%s,%s"), Row.Time, *Analyzer.GetOwnerName(Row.Owner), Row.Event, *Slot, *Row.Detail));
+
+		if (!CsvPath)
+			UE_LOG(LogGlowTrace, Display, TEXT("%12.6f  %-32s %-12s %3s  %s"), Row.Time, *Analyzer.GetOwnerName(Row.Owner), Row.Event, *Slot, *Row.Detail);
+	}
+
+	if (CsvPath && !FFileHelper::SaveStringArrayToFile(Lines, **CsvPath))
+	{
+		UE_LOG(LogGlowTrace, Error, TEXT("Could not write %s"), **CsvPath);
+		return 1;
+	}
+
+	for (const TPair<uint32, FGlowTraceAnalyzer::FOwnerSummary>& Pair : Analyzer.Summaries)
+	{
+		const FGlowTraceAnalyzer::FOwnerSummary& Summary = Pair.Value;
+		UE_LOG(LogGlowTrace, Display, TEXT("%s: %u hits, %u ignored, %u on a full pool, %u points started, %u evicted, %u uploads, at most %u live points"),
+			*Analyzer.GetOwnerName(Pair.Key), Summary.NumHits, Summary.NumIgnored, Summary.NumPoolFull, Summary.NumStarts,
+			Summary.NumEvictions, Summary.NumUploads, Summary.MaxLivePoints);
+	}
+
+	UE_LOG(LogGlowTrace, Display, TEXT("%d glow events in the range"), Analyzer.Rows.Num());
+	return 0;
+}
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GlowTraceCommandlet.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogGlowTrace, Log, All);
+
+/**
+ * Reads the Bioluminescence channel back from a trace, as a timeline in the same seconds as the Insights timing view,
+ * followed by a summary per actor
+ *
+ * Usage: UnrealEditor-Cmd.exe Tech_Art_Soleil.uproject -run=GlowTrace -Trace=Saved/Profiling/Session.utrace [-Csv=Saved/Profiling/Glow.csv] [-From=12.5 -To=13]
+ */
+UCLASS()
+class UGlowTraceCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGlowTraceCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};